@@ -2,6 +2,17 @@
 # It starts at the frame 300 and ends at the frame 400.
 # Using -t 4, the software will run on 4 threads.
 # Using -j 10, we will compute every 10 frames.
+# Adding --staged would run the background subtraction on a single thread,
+# giving the same results whatever the thread count is.
+# Using -b 10 instead of -j, every frame is shown and the boxes are refreshed
+# every 10 frames. Adding --adaptive tunes this rate on the fly to keep up
+# with the video (see the controller settings in config.cfg).
+# Adding --cameras 0,1,2 runs the cameras 0, 1 and 2 together in the same
+# process (the camera index argument is then ignored), the results being
+# saved as result_<camera>.avi.
+# Adding --shards 4 splits the frames between 4 processes instead, each one
+# giving the --warmup 50 frames before its part to the background model.
+# Their results are merged in result.avi and result.log.
 
 # The result is saved as result.avi.
 
@@ -0,0 +1,71 @@
+#ifndef BACHELOR_PROJECT_BGS_ENGINE_H
+#define BACHELOR_PROJECT_BGS_ENGINE_H
+
+#include <string>
+#include <stdexcept>
+#include <opencv2/core/core.hpp>
+#include "../misc/config.h"
+#include "../misc/debug.h"
+#include "mask_region.h"
+
+namespace tmd{
+
+    /**
+     * Abstract class of the models used by the BGSubstractor to tell the
+     * foreground pixels of a frame from the background ones.
+     */
+    class BGSEngine{
+    public:
+        virtual ~BGSEngine();
+
+        /**
+         * Update the model with the image (CV_8UC3) and compute its
+         * foreground mask (CV_8U, 255 for the foreground). The first image
+         * given becomes the background.
+         */
+        virtual void apply(const cv::Mat &image, cv::Mat &mask,
+                           double learning_rate) = 0;
+
+        /**
+         * Restrict the subtraction to the pixels of the given region (NULL
+         * for the whole frame). The other pixels are background in the
+         * masks. The region must outlive the engine, or be replaced before
+         * being destroyed.
+         */
+        virtual void set_region(const tmd::MaskRegion *region) = 0;
+
+        /**
+         * Set the distance from the background above which a pixel is
+         * foreground.
+         */
+        virtual void set_threshold(float threshold) = 0;
+
+        /**
+         * Set the number of frames the model remembers.
+         */
+        virtual void set_history(int history) = 0;
+
+        /**
+         * Write the model and the given static mask in the given file.
+         * Returns false if the file couldn't be written.
+         */
+        virtual bool save(const std::string &path,
+                          const cv::Mat &static_mask) = 0;
+
+        /**
+         * Replace the model and the given static mask with the ones saved in
+         * the given file.
+         * Returns false if the file couldn't be read, in which case nothing
+         * is changed.
+         */
+        virtual bool load(const std::string &path, cv::Mat &static_mask) = 0;
+
+        /**
+         * Create the engine set in the configuration (see
+         * Config::bgs_engine).
+         */
+        static BGSEngine *create();
+    };
+}
+
+#endif //BACHELOR_PROJECT_BGS_ENGINE_H
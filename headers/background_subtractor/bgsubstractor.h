@@ -8,17 +8,57 @@
 #include "../misc/debug.h"
 #include "../data_structures/frame_t.h"
 #include "../misc/config.h"
+#include "../frame_sources/frame_source.h"
+#include "../misc/asset_registry.h"
+#include "bgs_engine.h"
+#include "mask_region.h"
+#include "packed_mask.h"
+#include "../players_extraction/blob_based_extraction/blob_labeler.h"
 
 namespace tmd {
 
     /**
-     * Wrapper of the background subtractor class from openCV.
+     * Wrapper of the background subtraction model (see Config::bgs_engine).
      * This class take an input video and the user can retrieve each frame by
      * calling the next_frame method.
      * This can be seen as an iterator over the video, performing the
      * background subtraction over the returned frames.
+     * The video is read through a FrameSource (see Config::frame_source_type),
+     * decoded ahead on another thread if Config::frame_source_prefetch_size
+     * is positive.
+     *
+     * Every Config::bgs_checkpoint_interval frames, the background model is
+     * saved in Config::bgs_checkpoint_folder. A BGSubstractor reading the
+     * video restores the most recent snapshot taken before its starting
+     * frame, and feeds it the few frames in between. Without snapshot, it is
+     * fed the Config::bgs_warmup_frames frames before its starting frame.
+     * The snapshots are only saved by the BGSubstractors whose model went
+     * through the whole video up to the frame : the ones reading the video
+     * themselves, from its beginning (or from a snapshot), with a step of
+     * 1 or a positive Config::bgs_update_interval, and only if
+     * Config::bgs_save_checkpoints is set.
+     *
+     * By default, every returned frame updates the model. With a positive
+     * Config::bgs_update_interval, the model is updated by the frames whose
+     * index is a multiple of it instead, whatever the step : the skipped
+     * ones are decoded and given to the model, and the others are only
+     * compared with the model, which is much cheaper.
+     *
+     * The mask of a frame is given packed (one bit per pixel) in
+     * frame_t::packed_mask, get_mask() unpacks it when it is needed.
+     *
+     * With Config::bgs_downscale_factor > 1, the model, the static mask and
+     * the cleanup work on frames reduced by this factor, and so does the
+     * packed mask. The blobs are found in it, get_mask() scales it back to
+     * the size of the frame.
      */
     class BGSubstractor {
+        /**
+         * The test of the cleanup compares stream_mask() with the former
+         * loops, without a video.
+         */
+        friend class CleanupTester;
+
     public:
         /**
          * Constructor of the Background Substractor.
@@ -32,6 +72,15 @@ namespace tmd {
                       int starting_frame = 0, int ending_frame = -1, int
                       step_size = 1);
 
+        /**
+         * Constructor of a Background Substractor without input video. The
+         * frames are given by the user through process_frame().
+         * first_frame : The first frame of the video, used to initialize
+         * the background model.
+         * camera_index : The index of the camera.
+         */
+        BGSubstractor(const cv::Mat &first_frame, int camera_index);
+
         /**
          * Destructor of the BGS.
          */
@@ -39,14 +88,33 @@ namespace tmd {
 
         /**
          * Extract the next image from the input_video, apply BGS on it and
-         * return a frame_t* containing the original image, the background
-         * mask and the colored mask.
+         * return a frame_t* containing the original image and the
+         * background mask.
          *
          * Return NULL if there is no frame left in the input stream or if
          * the ending_frame has been reached.
          */
         frame_t *next_frame();
 
+        /**
+         * Apply BGS on the original image of the given frame, and set its
+         * background mask, mask_roi and camera index.
+         * The frames must be given in the order of the video. The frames
+         * flagged update_only only update the model, nothing is set.
+         *
+         * Returns the given frame.
+         */
+        frame_t *process_frame(frame_t *frame);
+
+        /**
+         * Bring the model of a BGSubstractor without input video to the
+         * state it would have before the given frame, as the constructor
+         * does with the video : from the most recent snapshot, fed the
+         * frames in between, or from the warm-up frames. These frames are
+         * read from the video of the camera in video_folder.
+         */
+        void catch_up(const std::string &video_folder, int frame_index);
+
         /**
          * Set the bgs to a given frame.
          */
@@ -73,10 +141,17 @@ namespace tmd {
         int get_current_frame_index();
 
     private:
-        cv::Ptr<cv::BackgroundSubtractorMOG2> m_bgs;
-        cv::VideoCapture m_input_video;
-        std::string m_input_video_path;
-        cv::Mat m_static_mask;
+        tmd::BGSEngine *m_bgs;
+        tmd::FrameSource *m_source; // NULL if the frames are given.
+        int m_images_per_step; // Images of m_source between two frames.
+        bool m_saves_checkpoints; // See Config::bgs_checkpoint_interval.
+        cv::Mat m_static_mask; // Shared with the registry, never written.
+        tmd::MaskRegion m_region; // Non zero pixels of the static mask.
+        tmd::MaskRegion m_cleanup_region; // m_region dilated for clean_row().
+        int m_cleanup_radius; // Dilation of m_cleanup_region, -1 if none.
+        tmd::PackedMask m_votes; // Ring of the rows of the bgs mask.
+        tmd::BlobLabeler m_labeler;
+        int m_downscale_factor; // See Config::bgs_downscale_factor.
         int m_camera_index;
         int m_frame_index;
         int m_total_frame_count;
@@ -86,8 +161,78 @@ namespace tmd {
         int m_ending_frame;
         int m_step_size;
 
+        void init_model(int camera_index, const cv::Mat &first_frame);
+
+        /**
+         * Restore the most recent snapshot of the model of this camera taken
+         * before the given frame (snapshots are taken at multiples of
+         * Config::bgs_checkpoint_interval).
+         * Returns the index of the frame of the snapshot, or -1 if there is
+         * none.
+         */
+        int restore_checkpoint(int frame_index);
+
+        /**
+         * Restore the model before the given frame, from m_source (see
+         * catch_up(video_folder, frame_index)).
+         * Returns whether the model went through every frame since the
+         * beginning of the video (or every update frame).
+         */
+        bool catch_up(int frame_index);
+
+        /**
+         * Update the model with the frames from "from" (included) to "to"
+         * (excluded) of m_source, without computing any result : every
+         * m_step_size frames, or the ones of is_update_frame() with
+         * Config::bgs_update_interval.
+         */
+        void feed_model(int from, int to);
+
+        /**
+         * Returns whether the frame of the given index updates the model
+         * (see Config::bgs_update_interval).
+         */
+        bool is_update_frame(int frame_index);
+        std::string get_checkpoint_path(int frame_index);
+        void save_checkpoint(int frame_index);
         void step();
-        int count_neighbours_in_fg(cv::Mat frame, int x, int y, int buffer_size);
+
+        /**
+         * Set the packed mask of the frame from the mask of the bgs, in a
+         * single pass over its rows. Every row is packed, its noise removed
+         * (see clean_row()), and, unless the players are extracted with
+         * the DPM, it is labeled (see BlobLabeler::add_row()) while it is
+         * still in the cache. The blobs are then in frame->mask_blobs.
+         * Only the 2 * Config::bgs_blob_buffer_size + 1 rows of the bgs
+         * mask around the current row are kept packed, in m_votes.
+         */
+        void stream_mask(const cv::Mat &mask, tmd::frame_t *frame);
+
+        /**
+         * Remove the noise of a row of the mask : the pixels close to the
+         * foreground are set to foreground or background depending on the
+         * number of foreground pixels around them in the bgs mask
+         * (Config::bgs_blob_buffer_size and
+         * Config::bgs_blob_threshold_count).
+         */
+        void clean_row(int row, tmd::PackedMask &mask);
+
+        /**
+         * Build m_region from the static mask and give it to the bgs.
+         */
+        void update_region();
+
+        /**
+         * Returns the pixels which can be changed by clean_row(), i.e.
+         * the region dilated by Config::bgs_blob_buffer_size.
+         */
+        const tmd::MaskRegion &get_cleanup_region();
+
+        /**
+         * Returns the image reduced by m_downscale_factor, which is the
+         * size the bgs works with.
+         */
+        cv::Mat reduce(const cv::Mat &image);
     };
 }
 
@@ -0,0 +1,50 @@
+#ifndef BACHELOR_PROJECT_CHECKPOINTABLE_MOG2_H
+#define BACHELOR_PROJECT_CHECKPOINTABLE_MOG2_H
+
+#include <string>
+#include <fstream>
+#include <opencv2/video/background_segm.hpp>
+
+namespace tmd{
+
+    /**
+     * The background subtractor of OpenCV, whose whole state can be saved
+     * to a binary file and restored later, so that the model does not have
+     * to be trained again from the beginning of the video.
+     *
+     * A snapshot contains the parameters of the model, the number of frames
+     * seen, the Gaussian mixtures and the static mask of the camera. Only
+     * the modes used by each pixel are stored.
+     */
+    class CheckpointableMOG2 : public cv::BackgroundSubtractorMOG2{
+    public:
+        /**
+         * Same as the constructor of cv::BackgroundSubtractorMOG2.
+         */
+        CheckpointableMOG2(int history, float var_threshold,
+                           bool shadow_detection);
+
+        /**
+         * Write the model and the given static mask in the given file.
+         * The file is first written under a temporary name and then renamed,
+         * so a crash never leaves a partial snapshot behind.
+         * Returns false if the file couldn't be written.
+         */
+        bool save(const std::string &path, const cv::Mat &static_mask);
+
+        /**
+         * Replace the model and the given static mask with the ones saved in
+         * the given file.
+         * Returns false if the file couldn't be read, in which case nothing
+         * is changed.
+         */
+        virtual bool load(const std::string &path, cv::Mat &static_mask);
+
+        /**
+         * Returns whether the model has already seen a frame.
+         */
+        bool is_initialized();
+    };
+}
+
+#endif //BACHELOR_PROJECT_CHECKPOINTABLE_MOG2_H
@@ -0,0 +1,69 @@
+#ifndef BACHELOR_PROJECT_MASK_REGION_H
+#define BACHELOR_PROJECT_MASK_REGION_H
+
+#include <vector>
+#include <opencv2/core/core.hpp>
+
+namespace tmd{
+
+    /**
+     * Structure representing the columns [begin, end[ of a row.
+     */
+    typedef struct{
+        int begin;
+        int end;
+    } span_t;
+
+    /**
+     * Class representing the non zero pixels of a static mask as, for each
+     * row, the list of the spans they form, together with their bounding
+     * box. It lets the background subtraction go through the pixels of
+     * interest only.
+     */
+    class MaskRegion{
+    public:
+        /**
+         * Constructor of an empty region.
+         */
+        MaskRegion();
+
+        /**
+         * Constructor of the region of the non zero pixels of the given
+         * mask (CV_8U).
+         */
+        MaskRegion(const cv::Mat &mask);
+
+        /**
+         * Returns the region of the pixels at most "radius" rows and
+         * columns away from a pixel of this region.
+         */
+        MaskRegion dilate(int radius) const;
+
+        /**
+         * Returns the spans of the given row, sorted by column.
+         */
+        const std::vector<span_t> &get_spans(int row) const;
+
+        /**
+         * Returns the smallest rectangle containing the region.
+         */
+        cv::Rect get_bounding_box() const;
+
+        /**
+         * Returns the size of the mask the region comes from.
+         */
+        cv::Size get_size() const;
+
+        /**
+         * Returns the number of pixels of the region.
+         */
+        long get_area() const;
+
+    private:
+        std::vector<std::vector<span_t>> m_spans; // One list per row.
+        cv::Rect m_bounding_box;
+        cv::Size m_size;
+    };
+}
+
+#endif //BACHELOR_PROJECT_MASK_REGION_H
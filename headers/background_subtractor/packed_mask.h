@@ -0,0 +1,103 @@
+#ifndef BACHELOR_PROJECT_PACKED_MASK_H
+#define BACHELOR_PROJECT_PACKED_MASK_H
+
+#include <vector>
+#include <cstdint>
+#include <opencv2/core/core.hpp>
+
+namespace tmd{
+
+    /**
+     * Foreground mask storing one bit per pixel : bit (col % 64) of the
+     * word (col / 64) of its row. Every row starts on a new word, and the
+     * bits after the last column are 0.
+     *
+     * It is 8 times smaller than the CV_8U masks, and the number of
+     * foreground pixels of a range of columns is counted a word at a time.
+     */
+    class PackedMask{
+    public:
+        /**
+         * Constructor of an empty mask.
+         */
+        PackedMask();
+
+        /**
+         * Constructor of a mask of the given size, without foreground.
+         */
+        PackedMask(int rows, int cols);
+
+        /**
+         * Constructor of the mask of the non zero pixels of "mask" (CV_8U)
+         * inside of "roi" (the whole mask if it is empty). The pixels
+         * outside of roi are background.
+         */
+        PackedMask(const cv::Mat &mask, const cv::Rect &roi = cv::Rect());
+
+        bool empty() const;
+
+        int get_rows() const;
+
+        int get_cols() const;
+
+        /**
+         * Returns whether the pixel is foreground.
+         */
+        bool test(int row, int col) const {
+            return ((m_words[row * m_words_per_row + (col >> 6)] >>
+                     (col & 63)) & 1) != 0;
+        }
+
+        /**
+         * Set whether the pixel is foreground.
+         */
+        void set(int row, int col, bool foreground) {
+            uint64_t &word = m_words[row * m_words_per_row + (col >> 6)];
+            const uint64_t bit = uint64_t(1) << (col & 63);
+            word = foreground ? word | bit : word & ~bit;
+        }
+
+        /**
+         * Returns the number of foreground pixels of the columns [begin,
+         * end[ of the row.
+         */
+        int count(int row, int begin, int end) const;
+
+        /**
+         * Returns the words of the given row.
+         */
+        const uint64_t *get_row(int row) const;
+
+        uint64_t *get_row(int row);
+
+        /**
+         * Replace the given row with the non zero bytes of the columns
+         * [begin, end[ of "pixels" (a row of a CV_8U mask). The other
+         * columns are background.
+         */
+        void pack_row(int row, const uchar *pixels, int begin, int end);
+
+        /**
+         * Set all the pixels of the given row to background.
+         */
+        void clear_row(int row);
+
+        /**
+         * Returns the number of words of every row.
+         */
+        int get_words_per_row() const;
+
+        /**
+         * Write the mask in "mask" (CV_8U, 255 for the foreground).
+         */
+        void unpack(cv::Mat &mask) const;
+
+    private:
+        std::vector<uint64_t> m_words;
+        int m_rows;
+        int m_cols;
+        int m_words_per_row;
+    };
+}
+
+#endif //BACHELOR_PROJECT_PACKED_MASK_H
@@ -0,0 +1,122 @@
+#ifndef BACHELOR_PROJECT_PARALLEL_MOG2_H
+#define BACHELOR_PROJECT_PARALLEL_MOG2_H
+
+#include <vector>
+#include "checkpointable_mog2.h"
+#include "bgs_engine.h"
+#include "mask_region.h"
+
+namespace tmd{
+
+    /**
+     * Our own implementation of the MOG2 background subtractor, using the
+     * same model (and thus the same snapshots) as the one of OpenCV.
+     *
+     * The mixture of each pixel is independent from the others, so the
+     * frame is split into bands of rows computed in parallel by the
+     * ThreadPool.
+     *
+     * With a learning rate of 0 (the default of bgs_learning_rate), the
+     * model is never modified and most pixels are classified by their
+     * first (heaviest) mode only. The first modes are then kept as a
+     * structure of arrays, and the test is vectorised with AVX2 or SSE2,
+     * chosen at runtime. The few pixels it can not decide go through the
+     * whole mixture.
+     *
+     * This is the "mog2" BGSEngine.
+     */
+    class ParallelMOG2 : public CheckpointableMOG2, public BGSEngine{
+    public:
+        /**
+         * Same as the constructor of cv::BackgroundSubtractorMOG2.
+         */
+        ParallelMOG2(int history, float var_threshold, bool shadow_detection);
+
+        /**
+         * Same as cv::BackgroundSubtractorMOG2 : updates the model with the
+         * image and computes its foreground mask. A negative learning rate
+         * uses 1 / min(2 * frames seen, history).
+         */
+        virtual void operator()(cv::InputArray image, cv::OutputArray fgmask,
+                                double learningRate = -1);
+
+        /**
+         * Same as operator(), see BGSEngine::apply().
+         */
+        virtual void apply(const cv::Mat &image, cv::Mat &mask,
+                           double learning_rate);
+
+        /**
+         * Restrict the subtraction to the pixels of the given region (NULL
+         * for the whole frame). The other pixels are left out of the model
+         * and are background in the masks. The region must outlive the
+         * subtractor, or be replaced before being destroyed.
+         */
+        virtual void set_region(const tmd::MaskRegion *region);
+
+        /**
+         * Set the variance threshold of the model (varThreshold).
+         */
+        virtual void set_threshold(float threshold);
+
+        virtual void set_history(int history);
+
+        virtual bool save(const std::string &path, const cv::Mat &static_mask);
+
+        virtual bool load(const std::string &path, cv::Mat &static_mask);
+
+    private:
+        /**
+         * Returns the spans of the given row to compute.
+         */
+        const std::vector<tmd::span_t> &get_spans(int row);
+
+        /**
+         * Update the model and compute the mask of the pixels of the region
+         * inside "box", as OpenCV does.
+         */
+        void update_rows(const cv::Mat &image, cv::Mat &mask,
+                         const cv::Rect &box, float learning_rate);
+
+        /**
+         * Update the mixture of one pixel and returns its value in the mask.
+         */
+        uchar update_pixel(const float *data, int channels, int pixel,
+                           float learning_rate);
+
+        /**
+         * Compute the mask of the pixels of the region inside "box" without
+         * modifying the model.
+         */
+        void classify_rows(const cv::Mat &image, cv::Mat &mask,
+                           const cv::Rect &box);
+
+        /**
+         * Classify one pixel with its whole mixture, without modifying it.
+         * Returns the value of the pixel in the mask.
+         */
+        uchar classify_pixel(const float *data, int channels, int pixel);
+
+        /**
+         * Returns whether the pixel is a shadow of one of its background
+         * modes.
+         */
+        bool is_shadow(const float *data, int channels, int modes,
+                       const float *gmm, const float *mean);
+
+        /**
+         * Build the arrays of the first modes from the model.
+         */
+        void build_first_modes();
+
+        // First mode of each pixel, as a structure of arrays.
+        std::vector<float> m_first_mean[3];
+        std::vector<float> m_first_variance; // Negative if there is none.
+        bool m_first_modes_valid;
+
+        const tmd::MaskRegion *m_region; // NULL for the whole frame.
+        std::vector<tmd::span_t> m_full_row; // Used without region.
+    };
+}
+
+#endif //BACHELOR_PROJECT_PARALLEL_MOG2_H
@@ -0,0 +1,75 @@
+#ifndef BACHELOR_PROJECT_STATIC_BACKGROUND_ENGINE_H
+#define BACHELOR_PROJECT_STATIC_BACKGROUND_ENGINE_H
+
+#include <vector>
+#include "bgs_engine.h"
+
+namespace tmd{
+
+    /**
+     * Background subtraction against a single background image, for
+     * venues whose lighting doesn't change (the empty room images, see
+     * Config::use_empty_room_images_as_background, or the first frame).
+     *
+     * A pixel is foreground if the absolute difference with the background
+     * is above the threshold of its channel for at least one channel. The
+     * test only needs saturated byte operations and is vectorised with
+     * AVX2 or SSE2, chosen at runtime. The rows are split into bands
+     * computed by the ThreadPool.
+     *
+     * With a positive learning rate, the background pixels are slowly
+     * blended into the background, kept in fixed point (16 fractional bits)
+     * so that small rates still move it. There is no shadow detection.
+     */
+    class StaticBackgroundEngine : public BGSEngine{
+    public:
+        /**
+         * Constructor of the engine, with the threshold of each channel
+         * (0 - 255).
+         */
+        StaticBackgroundEngine(int threshold_blue, int threshold_green,
+                               int threshold_red);
+
+        virtual void apply(const cv::Mat &image, cv::Mat &mask,
+                           double learning_rate);
+
+        virtual void set_region(const tmd::MaskRegion *region);
+
+        /**
+         * Use the same threshold for the three channels.
+         */
+        virtual void set_threshold(float threshold);
+
+        /**
+         * The background has no history, does nothing.
+         */
+        virtual void set_history(int history);
+
+        virtual bool save(const std::string &path, const cv::Mat &static_mask);
+
+        virtual bool load(const std::string &path, cv::Mat &static_mask);
+
+    private:
+        /**
+         * Returns the spans of the given row to compute.
+         */
+        const std::vector<tmd::span_t> &get_spans(int row);
+
+        /**
+         * Compute the mask of the pixels of the region in the rows [begin,
+         * end[, and blend the background ones with the given rate (16
+         * fractional bits, 0 to leave the background as it is).
+         */
+        void subtract_rows(const cv::Mat &image, cv::Mat &mask, int begin,
+                           int end, int rate);
+
+        cv::Mat m_background; // CV_8UC3, compared with the images.
+        cv::Mat m_accumulator; // CV_32SC3, m_background with 16 more bits.
+        uchar m_thresholds[3];
+
+        const tmd::MaskRegion *m_region; // NULL for the whole frame.
+        std::vector<tmd::span_t> m_full_row; // Used without region.
+    };
+}
+
+#endif //BACHELOR_PROJECT_STATIC_BACKGROUND_ENGINE_H
@@ -2,6 +2,7 @@
 #define BACHELOR_PROJECT_CMD_ARGS_T_H
 
 #include <string>
+#include <vector>
 
 namespace tmd{
 
@@ -10,7 +11,17 @@ namespace tmd{
      */
     typedef struct{
         bool test_run = false;
+        bool labeler_test = false;
+        bool cleanup_test = false;
         bool training_set_creator = false;
+        bool staged = false;
+        bool adaptive = false;
+        std::vector<int> cameras; // Empty unless --cameras is used.
+        std::string program = ""; // Path of the executable.
+        int shards = 1;
+        int warmup = -1; // Negative unless --warmup is used.
+        std::string shard_output = ""; // Only set in the shard processes.
+        bool no_checkpoints = false; // Only restore the bgs snapshots.
         std::string video_folder = "./";
         int camera_index = 0;
         int s = 0;
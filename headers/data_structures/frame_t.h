@@ -9,6 +9,9 @@
 #include "player_t.h"
 #include "features_t.h"
 #include "../misc/config.h"
+#include "../misc/mask_kernels.h"
+#include "../background_subtractor/packed_mask.h"
+#include "../players_extraction/blob_based_extraction/blob_labeler.h"
 
 namespace tmd {
 
@@ -20,11 +23,24 @@ namespace tmd {
     typedef struct {
         cv::Mat original_frame;         // Original frame taken from the video.
         int frame_index;                // Index of the frame in the video.
-        cv::Mat mask_frame;             // Frame after applying BGS.
-        cv::Mat colored_mask_frame;     // Colored mask of the frame.
+        int sequence_index;             // Position among decoded frames.
+        tmd::PackedMask packed_mask;    // Mask computed by the BGS, maybe
+                                        // reduced (bgs_downscale_factor).
+        std::vector<tmd::blob_t> mask_blobs; // Blobs of packed_mask,
+                                        // labeled by the BGS.
+        int mask_blobs_radius = -1;     // Radius of mask_blobs, -1 if
+                                        // they are not labeled.
+        cv::Mat mask_frame;             // Frame after applying BGS, see
+                                        // get_mask().
+        cv::Mat colored_mask_frame;     // Colored mask of the frame, see
+                                        // get_colored_mask().
         int camera_index;               // Index of the source camera.
         std::vector<tmd::player_t *> players;   // Players on the frame.
         std::vector<cv::Rect> blobs;    // The blobs on the the frame.
+        cv::Rect mask_roi;              // Part of mask_frame which can be
+                                        // foreground, empty if unknown.
+        bool update_only = false;       // Only given to the background
+                                        // model, see FrameDecoder.
     } frame_t;
 
     /**
@@ -39,36 +55,84 @@ namespace tmd {
         }
     }
 
+    /**
+     * Returns the mask of the frame, at the size of the frame. It is
+     * unpacked from packed_mask on the first call only, and kept in
+     * mask_frame.
+     */
+    inline const cv::Mat &get_mask(tmd::frame_t *frame) {
+        if (frame->mask_frame.empty() && !frame->packed_mask.empty()) {
+            frame->packed_mask.unpack(frame->mask_frame);
+            if (frame->mask_frame.size() != frame->original_frame.size()) {
+                cv::resize(frame->mask_frame, frame->mask_frame,
+                           frame->original_frame.size(), 0, 0,
+                           cv::INTER_NEAREST);
+            }
+        }
+        return frame->mask_frame;
+    }
+
     /**
      * Create a 'colored mask' ie all pixel belonging to the foreground
      * are in color whereas pixels from the background are black.
      */
-    inline cv::Mat get_colored_mask_for_frame(const tmd::frame_t* const frame) {
+    inline cv::Mat get_colored_mask_for_frame(tmd::frame_t *frame) {
         cv::Mat resulting_image;
-        frame->original_frame.copyTo(resulting_image);
-        cv::Vec3b black;
-        black.val[0] = 0;
-        black.val[1] = 0;
-        black.val[2] = 0;
-        for (int c = 0; c < frame->mask_frame.cols; c++) {
-            for (int r = 0; r < frame->mask_frame.rows; r++) {
-                if (frame->mask_frame.at<uchar>(r, c) < 127) {
-                    resulting_image.at<cv::Vec3b>(r, c) = black;
-                }
-            }
-        }
+        tmd::apply_masks(frame->original_frame, get_mask(frame), cv::Mat(),
+                         127, resulting_image);
         return resulting_image;
     }
 
+    /**
+     * Returns the colored mask of the frame (same as
+     * get_colored_mask_for_frame()). It is only computed on the first call,
+     * from the pixels of mask_roi, and kept in colored_mask_frame.
+     */
+    inline const cv::Mat &get_colored_mask(tmd::frame_t *frame) {
+        if (frame->colored_mask_frame.empty() && !get_mask(frame).empty()) {
+            tmd::apply_masks(frame->original_frame, frame->mask_frame,
+                             cv::Mat(), 127, frame->colored_mask_frame,
+                             frame->mask_roi);
+        }
+        return frame->colored_mask_frame;
+    }
+
+    /**
+     * Release the images of the frame which are not read anymore once it
+     * went through the DetectionStage : the results only need the original
+     * frame, unless results_image asks for one of the masks, which are then
+     * only kept packed. The images of the players are views on the frame
+     * and would keep it alive.
+     */
+    inline void release_intermediate_images(tmd::frame_t *frame) {
+        for (player_t *p : frame->players) {
+            p->mask_image.release();
+            p->original_image.release();
+        }
+        if (tmd::Config::results_image != 1) {
+            frame->colored_mask_frame.release();
+        }
+        if (tmd::Config::results_image == 0) {
+            frame->packed_mask = tmd::PackedMask();
+            frame->mask_frame.release();
+        }
+        else if (!frame->packed_mask.empty()) {
+            // Unpacked again if needed.
+            frame->mask_frame.release();
+        }
+    }
+
     /**
      * Draw the players of the frame on another image and returns it.
+     * result_flag chooses the image drawn on : 0 for the original frame, 1
+     * for the colored mask, 2 for the mask.
      */
     inline cv::Mat draw_player_on_frame(int result_flag, tmd::frame_t *frame) {
         cv::Mat result;
         if (result_flag == 1) {
-            result = frame->colored_mask_frame.clone();
+            result = get_colored_mask(frame).clone();
         } else if (result_flag == 2) {
-            cv::Mat temp = frame->mask_frame;
+            cv::Mat temp = get_mask(frame);
             cv::Mat in[] = {temp, temp, temp};
             cv::merge(in, 3, result);
         } else {
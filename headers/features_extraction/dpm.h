@@ -14,6 +14,7 @@
 #include "../openCV/_lsvm_routine.h"
 #include "../openCV/_lsvm_types.h"
 #include "../sdl_binds/sdl_binds.h"
+#include "../misc/asset_registry.h"
 
 namespace tmd{
     /**
@@ -40,6 +41,11 @@ namespace tmd{
      *  The code has not changed that much, however we had to take some
      *  function as is because our program could not find the declarations
      *  (the static functions in the .cpp files for example).
+     *
+     *  The model (Config::model_file_path) is loaded once and shared by all
+     *  the detectors (see AssetRegistry), so a detector is cheap to create.
+     *  A detector keeps the detections of its current call though, so it
+     *  can not be used by two threads at the same time.
      */
     class DPM {
     public:
@@ -73,6 +79,18 @@ namespace tmd{
         std::vector<tmd::player_t*> extract_players_and_body_parts
                 (tmd::frame_t* frame);
 
+        /**
+         * Set the number of threads used by all the detectors, instead of
+         * Config::dpm_detector_numthread. It can be called while other
+         * threads run detectors.
+         */
+        static void set_thread_count(int thread_count);
+
+        /**
+         * Returns the number of threads used by the detectors.
+         */
+        static int get_thread_count();
+
     private:
         /** The following functions are taken from the source code of the
          * LatentSVMDetector from openCV.
@@ -97,7 +115,7 @@ namespace tmd{
                                     algorithm.
         */
         void cvLatentSvmDetectObjects(IplImage* image,
-                                        CvLatentSvmDetector* detector,
+                                        const CvLatentSvmDetector* detector,
                                         CvMemStorage* storage,
                                         float overlap_threshold, int
                                         numThreads);
@@ -352,9 +370,9 @@ namespace tmd{
         void extractTorsoForPlayer(player_t *player, int component_level);
 
         /**
-         * The actual detector.
+         * The actual detector, shared with the other instances.
          */
-        CvLatentSvmDetector *m_detector;
+        const CvLatentSvmDetector *m_detector;
 
         /**
          * All the current detections.
@@ -0,0 +1,108 @@
+#ifndef BACHELOR_PROJECT_FRAME_SOURCE_H
+#define BACHELOR_PROJECT_FRAME_SOURCE_H
+
+#include <string>
+#include <stdexcept>
+#include <opencv2/core/core.hpp>
+#include "../misc/config.h"
+#include "../misc/debug.h"
+
+namespace tmd{
+
+    /**
+     * Abstract class giving the images of a camera one after the other,
+     * whatever they come from (video file, images, raw file, pipe, ...).
+     *
+     * skip() moves to the next image without decoding it whenever the
+     * source allows it, so skipped frames cost as little as possible.
+     * Sources which can not seek (pipes) only move forward.
+     */
+    class FrameSource{
+    public:
+        FrameSource();
+
+        virtual ~FrameSource();
+
+        /**
+         * Decode the next image in "image".
+         * Returns false if there is no image left.
+         */
+        bool read(cv::Mat &image);
+
+        /**
+         * Move to the next image without decoding it.
+         * Returns false if there is no image left.
+         */
+        bool skip();
+
+        /**
+         * Move to the image with the given index, so that it is the next one
+         * read. A source which can not seek only moves forward, by skipping
+         * the images in between.
+         * Returns false if the image can not be reached.
+         */
+        bool seek(int index);
+
+        /**
+         * Returns the index of the next image read.
+         */
+        int get_position();
+
+        /**
+         * Returns the first image of the stream (index 0), used to
+         * initialize the background models, without changing the position.
+         * Returns an empty image if it can not be read anymore.
+         */
+        cv::Mat get_first_frame();
+
+        /**
+         * Returns the number of images per second of the stream.
+         */
+        virtual double get_fps() = 0;
+
+        /**
+         * Returns the size of the images.
+         */
+        virtual cv::Size get_size() = 0;
+
+        /**
+         * Returns the number of images of the stream, or -1 if it is not
+         * known.
+         */
+        virtual int get_frame_count() = 0;
+
+        /**
+         * Create the source of the given camera, as set in the
+         * configuration (see Config::frame_source_type).
+         */
+        static FrameSource* open(const std::string &video_folder,
+                                 int camera_index);
+
+    protected:
+        /**
+         * Decode the next image, and update m_position.
+         */
+        virtual bool read_image(cv::Mat &image) = 0;
+
+        /**
+         * Move to the next image without decoding it, and update m_position.
+         */
+        virtual bool skip_image() = 0;
+
+        /**
+         * Move directly to the given image, and update m_position.
+         * Returns false if the source can not seek, which is the default.
+         */
+        virtual bool seek_image(int index);
+
+        int m_position; // Index of the next image of the implementation.
+
+    private:
+        cv::Mat m_first_frame;
+        // The first image has been read by get_first_frame() on a source
+        // which can not seek, it is given back by the next read().
+        bool m_replay_first_frame;
+    };
+}
+
+#endif //BACHELOR_PROJECT_FRAME_SOURCE_H
@@ -0,0 +1,51 @@
+#ifndef BACHELOR_PROJECT_IMAGE_SEQUENCE_SOURCE_H
+#define BACHELOR_PROJECT_IMAGE_SEQUENCE_SOURCE_H
+
+#include <opencv2/highgui/highgui.hpp>
+#include "frame_source.h"
+
+namespace tmd{
+
+    /**
+     * Source reading one image file per frame, e.g. ace_0/000042.jpg.
+     * Skipping an image only checks that its file exists.
+     */
+    class ImageSequenceSource : public FrameSource{
+    public:
+        /**
+         * Constructor of the source.
+         * folder : The folder containing the images.
+         * name_format : printf-like format of the file names, taking the
+         * index of the image, e.g. "%06d.jpg".
+         * fps : The number of images per second.
+         */
+        ImageSequenceSource(const std::string &folder,
+                            const std::string &name_format, double fps);
+
+        double get_fps();
+
+        cv::Size get_size();
+
+        int get_frame_count();
+
+    protected:
+        bool read_image(cv::Mat &image);
+
+        bool skip_image();
+
+        bool seek_image(int index);
+
+    private:
+        /**
+         * Returns the path of the image with the given index.
+         */
+        std::string get_image_path(int index);
+
+        std::string m_folder;
+        std::string m_name_format;
+        double m_fps;
+        cv::Size m_size;
+    };
+}
+
+#endif //BACHELOR_PROJECT_IMAGE_SEQUENCE_SOURCE_H
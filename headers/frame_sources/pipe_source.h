@@ -0,0 +1,28 @@
+#ifndef BACHELOR_PROJECT_PIPE_SOURCE_H
+#define BACHELOR_PROJECT_PIPE_SOURCE_H
+
+#include "raw_file_source.h"
+
+namespace tmd{
+
+    /**
+     * Source reading raw images (see RawFileSource) from the standard
+     * input, so that the capture system can feed the program directly.
+     * The stream can only be read once, forward : it can only be used by
+     * one camera and by pipelines reading the video a single time (not the
+     * approximative pipeline).
+     */
+    class PipeSource : public RawFileSource{
+    public:
+        /**
+         * Constructor of the source.
+         * width, height : The size of the images.
+         * format : "bgr" or "i420".
+         * fps : The number of images per second.
+         */
+        PipeSource(int width, int height, const std::string &format,
+                   double fps);
+    };
+}
+
+#endif //BACHELOR_PROJECT_PIPE_SOURCE_H
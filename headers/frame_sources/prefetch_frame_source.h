@@ -0,0 +1,80 @@
+#ifndef BACHELOR_PROJECT_PREFETCH_FRAME_SOURCE_H
+#define BACHELOR_PROJECT_PREFETCH_FRAME_SOURCE_H
+
+#include <thread>
+#include <atomic>
+#include "frame_source.h"
+#include "../misc/spsc_ring.h"
+
+namespace tmd{
+
+    /**
+     * Source decoding the images of another source ahead, on its own
+     * thread, and keeping them in a ring buffer until they are read.
+     *
+     * Only one image every "step" is decoded, the others being skipped by
+     * the underlying source : from the point of view of the user, the
+     * source only contains these images. Skipping one of them only drops
+     * it, as it is already decoded.
+     */
+    class PrefetchFrameSource : public FrameSource{
+    public:
+        /**
+         * Constructor of the source. Starts decoding from the current
+         * position of the given source.
+         * source : The source to read from. It is deleted with *this.
+         * step : One image every "step" images of the source is decoded.
+         * capacity : The number of images decoded ahead.
+         */
+        PrefetchFrameSource(FrameSource *source, int step, int capacity);
+
+        /**
+         * Destructor of the source. Stops the decoding thread.
+         */
+        ~PrefetchFrameSource();
+
+        double get_fps();
+
+        cv::Size get_size();
+
+        int get_frame_count();
+
+    protected:
+        bool read_image(cv::Mat &image);
+
+        bool skip_image();
+
+        /**
+         * Seek the underlying source, the index being one of the
+         * underlying source, and decode ahead from there.
+         */
+        bool seek_image(int index);
+
+    private:
+        /**
+         * Method executed by the decoding thread.
+         */
+        void decode();
+
+        /**
+         * Start and stop the decoding thread.
+         */
+        void start();
+        void stop();
+
+        FrameSource *m_source;
+        tmd::SPSCRing<cv::Mat> *m_ring; // An empty image marks the end.
+        std::thread m_worker;
+        std::atomic<bool> m_stop_request;
+        int m_step;
+        int m_capacity;
+        bool m_end_reached;
+
+        // Read before starting the thread, which owns m_source afterwards.
+        double m_fps;
+        cv::Size m_size;
+        int m_frame_count;
+    };
+}
+
+#endif //BACHELOR_PROJECT_PREFETCH_FRAME_SOURCE_H
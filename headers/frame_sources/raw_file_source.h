@@ -0,0 +1,73 @@
+#ifndef BACHELOR_PROJECT_RAW_FILE_SOURCE_H
+#define BACHELOR_PROJECT_RAW_FILE_SOURCE_H
+
+#include <cstdio>
+#include <vector>
+#include <opencv2/imgproc/imgproc.hpp>
+#include "frame_source.h"
+
+namespace tmd{
+
+    /**
+     * Source reading uncompressed images stored one after the other, as
+     * written by our capture system. Two formats are supported :
+     *      _ "bgr" : 3 bytes per pixel, in the order used by OpenCV.
+     *      _ "i420" : planar YUV 4:2:0 (Y plane, then U, then V).
+     * Skipping an image only moves in the file, without any conversion.
+     */
+    class RawFileSource : public FrameSource{
+    public:
+        /**
+         * Constructor of the source.
+         * file_path : The file containing the images.
+         * width, height : The size of the images.
+         * format : "bgr" or "i420".
+         * fps : The number of images per second.
+         */
+        RawFileSource(const std::string &file_path, int width, int height,
+                      const std::string &format, double fps);
+
+        ~RawFileSource();
+
+        double get_fps();
+
+        cv::Size get_size();
+
+        int get_frame_count();
+
+    protected:
+        /**
+         * Constructor of a source reading an already opened stream.
+         * seekable : Whether fseek() can be used on the stream.
+         * The stream is not closed by the destructor.
+         */
+        RawFileSource(FILE *stream, bool seekable, int width, int height,
+                      const std::string &format, double fps);
+
+        bool read_image(cv::Mat &image);
+
+        bool skip_image();
+
+        bool seek_image(int index);
+
+    private:
+        /**
+         * Check the parameters and set the size of an image in the stream.
+         */
+        void init(int width, int height, const std::string &format,
+                  double fps);
+
+        FILE *m_stream;
+        bool m_owns_stream;
+        bool m_seekable;
+        bool m_is_yuv;
+        int m_width;
+        int m_height;
+        double m_fps;
+        size_t m_image_bytes; // Size of an image in the stream.
+        int m_frame_count; // -1 if the stream is not seekable.
+        std::vector<unsigned char> m_skip_buffer; // For unseekable streams.
+    };
+}
+
+#endif //BACHELOR_PROJECT_RAW_FILE_SOURCE_H
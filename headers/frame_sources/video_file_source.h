@@ -0,0 +1,41 @@
+#ifndef BACHELOR_PROJECT_VIDEO_FILE_SOURCE_H
+#define BACHELOR_PROJECT_VIDEO_FILE_SOURCE_H
+
+#include <opencv2/highgui/highgui.hpp>
+#include "frame_source.h"
+
+namespace tmd{
+
+    /**
+     * Source reading a video file (the ace_<camera>.mp4 files).
+     * The skipped images are only grabbed, never decoded.
+     */
+    class VideoFileSource : public FrameSource{
+    public:
+        /**
+         * Constructor of the source.
+         * video_path : The path to the video.
+         */
+        VideoFileSource(const std::string &video_path);
+
+        ~VideoFileSource();
+
+        double get_fps();
+
+        cv::Size get_size();
+
+        int get_frame_count();
+
+    protected:
+        bool read_image(cv::Mat &image);
+
+        bool skip_image();
+
+        bool seek_image(int index);
+
+    private:
+        cv::VideoCapture m_video;
+    };
+}
+
+#endif //BACHELOR_PROJECT_VIDEO_FILE_SOURCE_H
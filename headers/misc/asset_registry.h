@@ -0,0 +1,66 @@
+#ifndef BACHELOR_PROJECT_ASSET_REGISTRY_H
+#define BACHELOR_PROJECT_ASSET_REGISTRY_H
+
+#include <map>
+#include <mutex>
+#include <string>
+#include <utility>
+#include <stdexcept>
+#include <opencv2/core/core.hpp>
+#include <opencv2/objdetect/objdetect.hpp>
+#include "config.h"
+#include "debug.h"
+
+namespace tmd{
+
+    /**
+     * Files loaded once for the whole program : the DPM models, the static
+     * masks, the backgrounds and the centers of the teams. Every pipeline,
+     * and every thread of a pipeline, gets the same copy.
+     *
+     * The assets are loaded on the first request and kept until the end of
+     * the program. They are shared, so they must never be modified : the
+     * images have to be cloned before being written.
+     *
+     * All the methods can be called from any thread.
+     */
+    class AssetRegistry{
+    public:
+        /**
+         * Destructor of the registry. Releases the DPM models.
+         */
+        ~AssetRegistry();
+
+        /**
+         * Returns the DPM model of the given file.
+         * Throws std::invalid_argument if it can not be loaded.
+         */
+        const CvLatentSvmDetector *get_dpm_model(const std::string &path);
+
+        /**
+         * Returns the image of the given file, read with the given flags
+         * (see cv::imread()). It is empty if the file can not be read.
+         */
+        cv::Mat get_image(const std::string &path, int flags = 1);
+
+        /**
+         * Returns the centers of the teams, read from
+         * Config::features_comparator_centers_file_name (see
+         * FeatureComparator::readCentersFromFile()).
+         */
+        cv::Mat get_centers();
+
+        /**
+         * Returns the registry shared by the whole program.
+         */
+        static AssetRegistry* get_instance();
+
+    private:
+        std::mutex m_lock;
+        std::map<std::string, CvLatentSvmDetector *> m_dpm_models;
+        std::map<std::pair<std::string, int>, cv::Mat> m_images;
+        std::map<std::string, cv::Mat> m_centers;
+    };
+}
+
+#endif //BACHELOR_PROJECT_ASSET_REGISTRY_H
@@ -0,0 +1,106 @@
+#ifndef BACHELOR_PROJECT_BOUNDED_QUEUE_H
+#define BACHELOR_PROJECT_BOUNDED_QUEUE_H
+
+#include <deque>
+#include <mutex>
+#include <condition_variable>
+
+namespace tmd{
+
+    /**
+     * Thread safe FIFO queue with a fixed capacity.
+     * push() blocks while the queue is full and pop() blocks while it is
+     * empty, so a producer can never get more than "capacity" entries ahead
+     * of its consumers.
+     *
+     * Once closed, push() fails immediately and pop() returns the remaining
+     * entries before failing too. This is used to wake up the threads
+     * waiting on the queue when a pipeline is destroyed.
+     */
+    template <typename T>
+    class BoundedQueue{
+    public:
+        /**
+         * Constructor of the queue.
+         * capacity : The maximum number of entries in the queue.
+         */
+        BoundedQueue(size_t capacity){
+            m_capacity = capacity > 0 ? capacity : 1;
+            m_closed = false;
+        }
+
+        /**
+         * Add an entry at the end of the queue, waiting for some room if
+         * needed.
+         * Returns false if the queue has been closed, in which case the
+         * entry has not been added.
+         */
+        bool push(T entry){
+            std::unique_lock<std::mutex> lock(m_lock);
+            m_not_full.wait(lock, [this]{
+                return m_closed || m_entries.size() < m_capacity;
+            });
+            if (m_closed){
+                return false;
+            }
+            m_entries.push_back(entry);
+            m_not_empty.notify_one();
+            return true;
+        }
+
+        /**
+         * Remove the oldest entry of the queue and put it in "entry",
+         * waiting for one if the queue is empty.
+         * Returns false if the queue has been closed and is empty.
+         */
+        bool pop(T &entry){
+            std::unique_lock<std::mutex> lock(m_lock);
+            m_not_empty.wait(lock, [this]{
+                return m_closed || !m_entries.empty();
+            });
+            if (m_entries.empty()){
+                return false;
+            }
+            entry = m_entries.front();
+            m_entries.pop_front();
+            m_not_full.notify_one();
+            return true;
+        }
+
+        /**
+         * Remove the oldest entry of the queue and put it in "entry",
+         * without waiting.
+         * Returns false if the queue is empty.
+         */
+        bool try_pop(T &entry){
+            std::lock_guard<std::mutex> lock(m_lock);
+            if (m_entries.empty()){
+                return false;
+            }
+            entry = m_entries.front();
+            m_entries.pop_front();
+            m_not_full.notify_one();
+            return true;
+        }
+
+        /**
+         * Close the queue and wake up every waiting thread.
+         */
+        void close(){
+            std::lock_guard<std::mutex> lock(m_lock);
+            m_closed = true;
+            m_not_full.notify_all();
+            m_not_empty.notify_all();
+        }
+
+    private:
+        std::deque<T> m_entries;
+        std::mutex m_lock;
+        std::condition_variable m_not_full;
+        std::condition_variable m_not_empty;
+        size_t m_capacity;
+        bool m_closed;
+    };
+}
+
+#endif //BACHELOR_PROJECT_BOUNDED_QUEUE_H
@@ -51,6 +51,7 @@ namespace tmd{
         static bool show_blobs;
         static bool show_player_team;
         static bool save_all_frames;
+        static int results_image;
 
         /**********************************************************************/
         /* BGS                                                                */
@@ -64,6 +65,16 @@ namespace tmd{
         static std::string bgs_empty_room_background;
         static bool use_empty_room_images_as_background;
         static bool use_bgs;
+        static int bgs_checkpoint_interval;
+        static std::string bgs_checkpoint_folder;
+        static bool bgs_save_checkpoints;
+        static int bgs_warmup_frames;
+        static int bgs_downscale_factor;
+        static int bgs_update_interval;
+        static std::string bgs_engine;
+        static int bgs_static_threshold_blue;
+        static int bgs_static_threshold_green;
+        static int bgs_static_threshold_red;
 
         /**********************************************************************/
         /* Calibration tool                                                   */
@@ -110,6 +121,39 @@ namespace tmd{
         /**********************************************************************/
         static int blob_player_extractor_buffer_size;
         static int blob_player_extractor_min_blob_size;
+
+        /**********************************************************************/
+        /* Pipelines                                                          */
+        /**********************************************************************/
+        static int pipeline_buffer_size;
+        static int thread_pool_size;
+        static int multi_camera_max_skew;
+
+        /**********************************************************************/
+        /* Frame sources                                                      */
+        /**********************************************************************/
+        static std::string frame_source_type;
+        static std::string frame_source_image_format;
+        static std::string frame_source_raw_format;
+        static int frame_source_width;
+        static int frame_source_height;
+        static float frame_source_fps;
+        static int frame_source_prefetch_size;
+
+        /**********************************************************************/
+        /* Output sink                                                        */
+        /**********************************************************************/
+        static int output_queue_size;
+        static int output_jpeg_threads;
+
+        /**********************************************************************/
+        /* Real time controller                                               */
+        /**********************************************************************/
+        static float controller_target_latency;
+        static int controller_window;
+        static int controller_max_box_step;
+        static int controller_max_blob_size;
+        static int controller_max_dpm_threads;
     };
 }
 
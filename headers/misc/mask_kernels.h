@@ -0,0 +1,28 @@
+#ifndef BACHELOR_PROJECT_MASK_KERNELS_H
+#define BACHELOR_PROJECT_MASK_KERNELS_H
+
+#include <stdexcept>
+#include <opencv2/core/core.hpp>
+#include "debug.h"
+
+namespace tmd{
+
+    /**
+     * Write in "output" the pixels of "image" (CV_8UC3) which are
+     * foreground, i.e. whose value in "mask" (CV_8U) is at least
+     * "threshold" and whose value in "static_mask" (CV_8U, may be empty) is
+     * not zero. The other pixels are black.
+     *
+     * Only the rows and columns of "roi" (the whole image if it is empty)
+     * are looked at, the pixels around it are black. The three masks are
+     * read and the output written in a single pass, row by row, with SSSE3
+     * when the processor supports it.
+     *
+     * "output" is allocated if needed, and may be "image" itself.
+     */
+    void apply_masks(const cv::Mat &image, const cv::Mat &mask,
+                     const cv::Mat &static_mask, int threshold,
+                     cv::Mat &output, const cv::Rect &roi = cv::Rect());
+}
+
+#endif //BACHELOR_PROJECT_MASK_KERNELS_H
@@ -0,0 +1,107 @@
+#ifndef BACHELOR_PROJECT_REORDER_BUFFER_H
+#define BACHELOR_PROJECT_REORDER_BUFFER_H
+
+#include <map>
+#include <mutex>
+#include <condition_variable>
+
+namespace tmd{
+
+    /**
+     * Thread safe buffer putting back in order entries produced out of
+     * order by several threads.
+     * Each entry comes with its sequence number (0, 1, 2, ...) and pop()
+     * always returns the entries in the order of their sequence numbers.
+     *
+     * At most "capacity" sequence numbers can be waiting ahead of the next
+     * one to pop : a producer pushing an entry further away waits until
+     * the consumer catches up. The entry expected by the consumer is
+     * always accepted, so this can not deadlock.
+     */
+    template <typename T>
+    class ReorderBuffer{
+    public:
+        /**
+         * Constructor of the buffer.
+         * capacity : The maximum distance between the sequence number of an
+         * entry and the next sequence number to pop.
+         */
+        ReorderBuffer(long capacity){
+            m_capacity = capacity > 0 ? capacity : 1;
+            m_next_sequence = 0;
+            m_closed = false;
+        }
+
+        /**
+         * Add the entry with the given sequence number, waiting until it is
+         * close enough to the next sequence number to pop.
+         * Returns false if the buffer has been closed, in which case the
+         * entry has not been added.
+         */
+        bool push(long sequence, T entry){
+            std::unique_lock<std::mutex> lock(m_lock);
+            m_has_room.wait(lock, [this, sequence]{
+                return m_closed || sequence < m_next_sequence + m_capacity;
+            });
+            if (m_closed){
+                return false;
+            }
+            m_entries[sequence] = entry;
+            if (sequence == m_next_sequence){
+                m_next_ready.notify_one();
+            }
+            return true;
+        }
+
+        /**
+         * Remove the entry with the next sequence number and put it in
+         * "entry", waiting for it if it has not been pushed yet.
+         * Returns false if the buffer has been closed.
+         */
+        bool pop(T &entry){
+            std::unique_lock<std::mutex> lock(m_lock);
+            m_next_ready.wait(lock, [this]{
+                return m_closed ||
+                       m_entries.find(m_next_sequence) != m_entries.end();
+            });
+            if (m_closed){
+                return false;
+            }
+            typename std::map<long, T>::iterator it =
+                    m_entries.find(m_next_sequence);
+            entry = it->second;
+            m_entries.erase(it);
+            m_next_sequence++;
+            m_has_room.notify_all();
+            return true;
+        }
+
+        /**
+         * Close the buffer and wake up every waiting thread.
+         * The entries which have not been popped are given back in
+         * "remaining" so that the caller can release them.
+         */
+        template <typename Container>
+        void close(Container &remaining){
+            std::lock_guard<std::mutex> lock(m_lock);
+            m_closed = true;
+            for (auto &it : m_entries){
+                remaining.push_back(it.second);
+            }
+            m_entries.clear();
+            m_has_room.notify_all();
+            m_next_ready.notify_all();
+        }
+
+    private:
+        std::map<long, T> m_entries;
+        std::mutex m_lock;
+        std::condition_variable m_has_room;
+        std::condition_variable m_next_ready;
+        long m_capacity;
+        long m_next_sequence;
+        bool m_closed;
+    };
+}
+
+#endif //BACHELOR_PROJECT_REORDER_BUFFER_H
@@ -0,0 +1,123 @@
+#ifndef BACHELOR_PROJECT_SPSC_RING_H
+#define BACHELOR_PROJECT_SPSC_RING_H
+
+#include <vector>
+#include <atomic>
+#include <mutex>
+#include <condition_variable>
+
+namespace tmd{
+
+    /**
+     * Fixed capacity ring buffer between exactly one producer thread and one
+     * consumer thread.
+     * As long as the ring is neither empty nor full, push() and pop() only
+     * use atomic loads and stores. A thread which has to wait (full ring for
+     * the producer, empty ring for the consumer) sleeps on a condition
+     * variable instead of spinning, and is woken up by the other side.
+     */
+    template <typename T>
+    class SPSCRing{
+    public:
+        /**
+         * Constructor of the ring.
+         * capacity : The maximum number of elements in the ring.
+         */
+        SPSCRing(size_t capacity) : m_slots((capacity > 0 ? capacity : 1) + 1){
+            m_head = 0;
+            m_tail = 0;
+            m_closed = false;
+            m_consumer_waiting = false;
+            m_producer_waiting = false;
+        }
+
+        /**
+         * Add an element at the end of the ring, waiting while it is full.
+         * Only called by the producer.
+         * Returns false if the ring has been closed, in which case the
+         * element has not been added.
+         */
+        bool push(T element){
+            const size_t tail = m_tail.load(std::memory_order_relaxed);
+            const size_t next_tail = (tail + 1) % m_slots.size();
+
+            if (next_tail == m_head.load(std::memory_order_acquire)){
+                std::unique_lock<std::mutex> lock(m_lock);
+                m_producer_waiting = true;
+                m_has_room.wait(lock, [this, next_tail]{
+                    return m_closed || next_tail != m_head.load();
+                });
+                m_producer_waiting = false;
+            }
+            if (m_closed){
+                return false;
+            }
+
+            m_slots[tail] = element;
+            m_tail.store(next_tail);
+            if (m_consumer_waiting.load()){
+                std::lock_guard<std::mutex> lock(m_lock);
+                m_has_elements.notify_one();
+            }
+            return true;
+        }
+
+        /**
+         * Remove the oldest element of the ring and put it in "element",
+         * waiting while the ring is empty.
+         * Only called by the consumer.
+         * Returns false if the ring has been closed and is empty.
+         */
+        bool pop(T &element){
+            const size_t head = m_head.load(std::memory_order_relaxed);
+
+            if (head == m_tail.load(std::memory_order_acquire)){
+                std::unique_lock<std::mutex> lock(m_lock);
+                m_consumer_waiting = true;
+                m_has_elements.wait(lock, [this, head]{
+                    return m_closed || head != m_tail.load();
+                });
+                m_consumer_waiting = false;
+                if (head == m_tail.load()){
+                    return false; // Closed and empty.
+                }
+            }
+
+            element = m_slots[head];
+            m_head.store((head + 1) % m_slots.size());
+            if (m_producer_waiting.load()){
+                std::lock_guard<std::mutex> lock(m_lock);
+                m_has_room.notify_one();
+            }
+            return true;
+        }
+
+        /**
+         * Close the ring : the producer can not push anymore and both
+         * threads are woken up. The consumer can still pop the elements
+         * left in the ring.
+         */
+        void close(){
+            std::lock_guard<std::mutex> lock(m_lock);
+            m_closed = true;
+            m_has_room.notify_all();
+            m_has_elements.notify_all();
+        }
+
+    private:
+        // One slot is always left empty to tell a full ring from an empty one.
+        std::vector<T> m_slots;
+        std::atomic<size_t> m_head; // Next slot to pop, owned by the consumer.
+        std::atomic<size_t> m_tail; // Next slot to push, owned by the producer.
+
+        // Only used by a thread which has to wait for the other one.
+        std::mutex m_lock;
+        std::condition_variable m_has_room;
+        std::condition_variable m_has_elements;
+        std::atomic<bool> m_closed;
+        std::atomic<bool> m_consumer_waiting;
+        std::atomic<bool> m_producer_waiting;
+    };
+}
+
+#endif //BACHELOR_PROJECT_SPSC_RING_H
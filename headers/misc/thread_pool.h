@@ -0,0 +1,92 @@
+#ifndef BACHELOR_PROJECT_THREAD_POOL_H
+#define BACHELOR_PROJECT_THREAD_POOL_H
+
+#include <vector>
+#include <deque>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <atomic>
+#include <functional>
+#include "config.h"
+#include "debug.h"
+
+namespace tmd{
+
+    /**
+     * Pool of threads executing short tasks, using work stealing :
+     * every thread has its own queue of tasks, which it empties from the
+     * front. Once its queue is empty, a thread steals the tasks at the back
+     * of the queues of the other threads.
+     *
+     * A thread submitting tasks helps executing them while it waits, so
+     * tasks can submit tasks themselves without risking a deadlock.
+     */
+    class ThreadPool{
+    public:
+        typedef std::function<void()> task_t;
+
+        /**
+         * Constructor of the pool.
+         * thread_count : The number of threads of the pool. If it is not
+         * positive, one thread per core is used.
+         */
+        ThreadPool(int thread_count);
+
+        /**
+         * Destructor of the pool. Waits for the running tasks to finish.
+         */
+        ~ThreadPool();
+
+        /**
+         * Execute the given tasks and return once all of them are done.
+         * The tasks are dealt to the threads in the given order, so the
+         * first tasks are the first ones to start.
+         */
+        void run_all(const std::vector<task_t> &tasks);
+
+        /**
+         * Returns the number of threads of the pool.
+         */
+        int get_thread_count();
+
+        /**
+         * Returns the pool shared by the whole program. It is created on the
+         * first call, with Config::thread_pool_size threads.
+         */
+        static ThreadPool* get_instance();
+
+    private:
+        /**
+         * Queue of tasks belonging to one thread.
+         */
+        typedef struct{
+            std::deque<task_t> tasks;
+            std::mutex lock;
+        } worker_queue_t;
+
+        /**
+         * Method executed by the threads of the pool.
+         */
+        void run_worker(int worker_id);
+
+        /**
+         * Take a task from the front of the queue of the given thread, or
+         * steal one from the back of the other queues.
+         * worker_id is -1 for threads not belonging to the pool.
+         * Returns false if every queue is empty.
+         */
+        bool take_task(int worker_id, task_t &task);
+
+        std::vector<worker_queue_t*> m_queues;
+        std::vector<std::thread> m_workers;
+        std::atomic<int> m_next_queue; // Queue receiving the next task.
+
+        std::mutex m_sleep_lock;
+        std::condition_variable m_wake_up;
+        int m_pending_tasks; // Tasks waiting in the queues.
+        bool m_stop;
+    };
+}
+
+#endif //BACHELOR_PROJECT_THREAD_POOL_H
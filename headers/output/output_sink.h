@@ -0,0 +1,81 @@
+#ifndef BACHELOR_PROJECT_OUTPUT_SINK_H
+#define BACHELOR_PROJECT_OUTPUT_SINK_H
+
+#include <string>
+#include <vector>
+#include <utility>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <opencv2/highgui/highgui.hpp>
+#include "../misc/bounded_queue.h"
+#include "../misc/config.h"
+#include "../misc/debug.h"
+#include "../sdl_binds/sdl_binds.h"
+
+namespace tmd{
+
+    /**
+     * Class taking care of the results (the frames with the boxes drawn) on
+     * its own threads, so that encoding them does not slow down the thread
+     * getting the frames from the pipeline :
+     *      _ One thread writes the result video. It gets every frame, the
+     *      caller waits if it is too far behind.
+     *      _ Config::output_jpeg_threads threads save the frames as JPEG
+     *      files, in parallel. They also get every frame.
+     *      _ One thread owns the SDL window and shows the frames. If it is
+     *      behind, only the most recent frame is shown and the others are
+     *      dropped.
+     */
+    class OutputSink{
+    public:
+        /**
+         * Constructor of the sink.
+         * video_path : The result video, or "" to not save it.
+         * fps : The frame rate of the result video.
+         * size : The size of the frames.
+         * frame_prefix : The path of the JPEG files without the frame index
+         * and extension (e.g. "./frames/frame"), or "" to not save them.
+         * show : Whether the frames are shown in a window.
+         */
+        OutputSink(const std::string &video_path, double fps, cv::Size size,
+                   const std::string &frame_prefix, bool show);
+
+        /**
+         * Destructor of the sink. Waits until every frame has been written,
+         * and closes the window.
+         */
+        ~OutputSink();
+
+        /**
+         * Give a result to the sink. The image must not be modified
+         * afterwards.
+         */
+        void write(const cv::Mat &result, int frame_index);
+
+    private:
+        /**
+         * Methods executed by the threads of the sink.
+         */
+        void run_video_writer();
+        void run_jpeg_encoder();
+        void run_display();
+
+        cv::VideoWriter *m_writer; // NULL if the video is not saved.
+        tmd::BoundedQueue<cv::Mat> *m_video_frames;
+        std::thread m_video_worker;
+
+        std::string m_frame_prefix;
+        tmd::BoundedQueue<std::pair<int, cv::Mat>> *m_jpeg_frames;
+        std::vector<std::thread> m_jpeg_workers;
+
+        bool m_show;
+        std::thread m_display_worker;
+        std::mutex m_display_lock;
+        std::condition_variable m_display_ready;
+        cv::Mat m_display_frame; // Most recent frame not shown yet.
+        bool m_display_closed;
+    };
+}
+
+#endif //BACHELOR_PROJECT_OUTPUT_SINK_H
@@ -3,7 +3,12 @@
 
 #include <thread>         // std::this_thread::sleep_for
 #include <chrono>         // std::chrono::seconds
+#include <atomic>
+#include <mutex>
+#include <condition_variable>
 #include "multithreaded_pipeline.h"
+#include "real_time_controller.h"
+#include "../frame_sources/prefetch_frame_source.h"
 
 namespace tmd{
 
@@ -12,6 +17,14 @@ namespace tmd{
      * certain rate.
      * The performances are then better than with a normal Pipeline.
      * It allow us to reach Real-Time if the rate is correctly chosen.
+     *
+     * The boxes are computed in the background, by a refreshing thread, so
+     * that displaying the frames never waits for them : every frame is drawn
+     * with the most recent boxes available. A set of boxes is only used once
+     * the display has reached the frame it was computed on.
+     *
+     * In adaptive mode, a RealTimeController changes the box step (and
+     * other settings) along the way to keep the boxes close to the display.
      */
     class ApproximativePipeline : public Pipeline{
 
@@ -24,10 +37,11 @@ namespace tmd{
          * start_frame : The index of the first frame to begin.
          * end_frame : The index of the last frame to compute.
          * box_step : The number of frames before recomputing the boxes.
+         * adaptive : Whether the box step is tuned on the fly.
          */
         ApproximativePipeline(const std::string &video_folder, int camera_index,
                          int thread_count, int start_frame, int end_frame,
-                         int box_step);
+                         int box_step, bool adaptive);
 
         /**
          * Destrucrtor of the Approximative Pipeline.
@@ -42,14 +56,30 @@ namespace tmd{
          * refreshed (except for the image obviously), the frame_t* returned
          * is always the same. Thus the user MUST NOT free the frame after
          * using it, nor modify it.
+         * Until the first boxes are computed, the frame has no player.
          */
         frame_t* next_frame();
 
     private:
+        /**
+         * Method executed by the refreshing thread.
+         */
+        void refresh_boxes();
+
+        tmd::FrameSource *m_source; // Source of every frame displayed.
         int m_box_step;
         int m_frame_pos;
-        tmd::Pipeline *m_pipeline;
-        tmd::frame_t *m_last_frame_computed;
+        tmd::MultithreadedPipeline *m_pipeline;
+        tmd::frame_t *m_last_frame_computed; // Only used by the display.
+        tmd::RealTimeController *m_controller; // NULL if not adaptive.
+        double m_fps;
+
+        std::thread m_refresher;
+        std::atomic<tmd::frame_t*> m_pending_frame; // Boxes ready to be used.
+        std::atomic<int> m_display_pos; // Index of the last frame displayed.
+        std::mutex m_display_lock;
+        std::condition_variable m_display_moved;
+        std::atomic<bool> m_stop_request;
 
         double m_frame_delay; // Minimum time between to frames.
         double m_last_frame_time; // Last time a frame was returned.
@@ -0,0 +1,57 @@
+#ifndef BACHELOR_PROJECT_DETECTION_STAGE_H
+#define BACHELOR_PROJECT_DETECTION_STAGE_H
+
+#include "../data_structures/frame_t.h"
+#include "../players_extraction/player_extractor.h"
+#include "../players_extraction/dpm_based_extraction/dpm_player_extractor.h"
+#include "../players_extraction/blob_based_extraction/blob_player_extractor.h"
+#include "../players_extraction/blob_based_extraction/blob_separator.h"
+#include "../features_extraction/features_extractor.h"
+#include "../features_comparison/feature_comparator.h"
+#include "../misc/asset_registry.h"
+
+namespace tmd{
+    /**
+     * Every step of the algorithm coming after the background subtraction :
+     * players extraction, blob separation, features extraction and team
+     * detection.
+     *
+     * These steps only depend on the frame they are applied to, so
+     * different frames can go through different DetectionStages at the same
+     * time, on different threads.
+     */
+    class DetectionStage{
+    public:
+        /**
+         * Constructor of the DetectionStage.
+         * Every parameter is taken from the configuration, the centers of
+         * the teams are the ones of the AssetRegistry.
+         */
+        DetectionStage();
+
+        /**
+         * Constructor of the DetectionStage, using the given centers of the
+         * teams instead of reading them from the centers file. The matrix
+         * is shared, not copied.
+         */
+        DetectionStage(const cv::Mat &centers);
+
+        /**
+         * Destructor of the DetectionStage.
+         */
+        ~DetectionStage();
+
+        /**
+         * Extract the players from the given frame, which must have gone
+         * through the BGS, and set their properties (team, features, ...).
+         */
+        void process_frame(tmd::frame_t *frame);
+
+    private:
+        tmd::PlayerExtractor    *m_playerExtractor;
+        tmd::FeaturesExtractor  *m_featuresExtractor;
+        tmd::FeatureComparator  *m_featuresComparator;
+    };
+}
+
+#endif //BACHELOR_PROJECT_DETECTION_STAGE_H
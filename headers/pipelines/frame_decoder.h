@@ -0,0 +1,137 @@
+#ifndef BACHELOR_PROJECT_FRAME_DECODER_H
+#define BACHELOR_PROJECT_FRAME_DECODER_H
+
+#include <string>
+#include <vector>
+#include <thread>
+#include <atomic>
+#include "../data_structures/frame_t.h"
+#include "../misc/bounded_queue.h"
+#include "../misc/debug.h"
+#include "../frame_sources/frame_source.h"
+
+namespace tmd{
+    /**
+     * Class decoding the input video on its own thread.
+     * Each frame is read once and handed to one of the outputs, in a
+     * round-robin fashion :
+     * Frame index : s s+j s+2j ... s+(n-1)j s+nj ...
+     * Output :      0  1   2   ...    n-1    0   ...
+     * where n is the number of outputs and j the step size.
+     * The sequence index of a frame is its position among the decoded
+     * frames, even if the step size changes along the way.
+     *
+     * With update_frames and a positive Config::bgs_update_interval, the
+     * skipped frames which update the background models are decoded as
+     * well, and every output gets a copy of them, flagged update_only. They
+     * are not counted in the sequence indices. This is only meaningful if
+     * every output is read by a single background model.
+     * When several threads share an output, the copies go instead to one
+     * update output per thread (see get_update_output()), which also gets
+     * a copy of the computed frames updating the models, pushed before the
+     * frame itself.
+     *
+     * When there is no frame left, NULL is pushed to every output and the
+     * outputs are closed, so that several threads can share one output :
+     * every one of them then gets either NULL or a failed pop().
+     */
+    class FrameDecoder{
+    public:
+        /**
+         * Constructor of the FrameDecoder.
+         * video_folder : Folder containing the video.
+         * camera_index : The camera index.
+         * start_frame : The index of the first frame to decode.
+         * end_frame : The index of the last frame to decode.
+         * step_size : The "distance" between to consecutive frames.
+         * output_count : The number of outputs to feed.
+         * update_frames : Whether the skipped frames updating the
+         * background models are given to the outputs.
+         * update_output_count : The number of update outputs, 0 to give
+         * these frames to the outputs themselves.
+         */
+        FrameDecoder(std::string video_folder, int camera_index,
+                     int start_frame, int end_frame, int step_size,
+                     int output_count, bool update_frames = false,
+                     int update_output_count = 0);
+
+        /**
+         * Destructor of the FrameDecoder. Stops the decoding thread and
+         * frees the frames which have not been consumed.
+         */
+        ~FrameDecoder();
+
+        /**
+         * Returns the queue containing the frames of the given output.
+         * The frames popped from it belong to the caller.
+         */
+        tmd::BoundedQueue<tmd::frame_t*>* get_output(int index);
+
+        /**
+         * Returns the queue containing the update frames of the given update
+         * output, in the order of the video, or NULL if there is no update
+         * output. The frames popped from it belong to the caller.
+         */
+        tmd::BoundedQueue<tmd::frame_t*>* get_update_output(int index);
+
+        /**
+         * Returns the first frame of the video, used to initialize the
+         * background models.
+         */
+        cv::Mat get_first_frame();
+
+        /**
+         * Returns the number of frames handed to the outputs so far. Once an
+         * output has been closed, this is the total number of frames.
+         */
+        long get_frame_count();
+
+        /**
+         * Change the step size. It applies from the next decoded frame.
+         */
+        void set_step_size(int step_size);
+
+        /**
+         * Stop decoding and close the outputs. Any thread waiting on one of
+         * the outputs is woken up.
+         */
+        void stop();
+
+    private:
+        /**
+         * Method executed by the decoding thread.
+         */
+        void decode();
+
+        /**
+         * Decode the skipped frame of the given index, or skip it if it
+         * doesn't update the background models.
+         * Returns false if the outputs are closed.
+         */
+        bool skip_frame(int frame_index);
+
+        /**
+         * Give a copy of the image, flagged update_only, to every update
+         * output, or to every output if there is no update output.
+         * Returns false if the outputs are closed.
+         */
+        bool push_update(const cv::Mat &image, int frame_index);
+
+        tmd::FrameSource *m_source;
+        cv::Mat m_first_frame;
+        std::vector<tmd::BoundedQueue<tmd::frame_t*>*> m_outputs;
+        std::vector<tmd::BoundedQueue<tmd::frame_t*>*> m_update_outputs;
+        std::thread m_worker; // The decoding thread.
+
+        int m_camera_index;
+        int m_start;
+        int m_end;
+        std::atomic<int> m_step;
+        bool m_update_frames;
+
+        std::atomic<bool> m_stop_request;
+        std::atomic<long> m_frame_count;
+    };
+}
+
+#endif //BACHELOR_PROJECT_FRAME_DECODER_H
@@ -0,0 +1,85 @@
+#ifndef BACHELOR_PROJECT_MULTI_CAMERA_PIPELINE_H
+#define BACHELOR_PROJECT_MULTI_CAMERA_PIPELINE_H
+
+#include <string>
+#include <vector>
+#include <thread>
+#include <atomic>
+#include "frame_decoder.h"
+#include "detection_stage.h"
+#include "../background_subtractor/bgsubstractor.h"
+#include "../misc/bounded_queue.h"
+
+namespace tmd{
+    /**
+     * Class running the whole algorithm on several cameras of the same
+     * venue at once, in a single process.
+     *
+     * Every camera has its own decoder, background model and thread. The
+     * read-only data (the centers of the teams, the DPM models used to
+     * separate the blobs) and the ThreadPool separating the blobs are shared
+     * by all the cameras.
+     *
+     * The frames are returned camera by camera, all with the same frame
+     * index. A camera can not get more than
+     * Config::multi_camera_max_skew + 1 frames ahead of the slowest one.
+     */
+    class MultiCameraPipeline{
+    public:
+        /**
+         * Constructor of the Multi Camera Pipeline.
+         * video_folder : Folder containing the videos.
+         * camera_indices : The indices of the cameras to use.
+         * start_frame : The index of the first frame to begin.
+         * end_frame : The index of the last frame to compute.
+         * step_size : The "distance" between to consecutive frames.
+         */
+        MultiCameraPipeline(std::string video_folder,
+                            std::vector<int> camera_indices, int start_frame,
+                            int end_frame, int step_size);
+
+        /**
+         * Destructor of the Multi Camera Pipeline. Stops every thread.
+         */
+        ~MultiCameraPipeline();
+
+        /**
+         * Returns the next frame of every camera, in the order of the camera
+         * indices given to the constructor.
+         * If one of the cameras has no frame left, the method returns an
+         * empty vector.
+         *
+         * Note that the user has to take care of freeing the frames.
+         */
+        std::vector<tmd::frame_t*> next_frames();
+
+        /**
+         * Returns the indices of the cameras used.
+         */
+        std::vector<int> get_camera_indices();
+
+    private:
+        /**
+         * Everything belonging to one camera.
+         */
+        typedef struct{
+            int camera_index;
+            tmd::FrameDecoder *decoder;
+            tmd::BGSubstractor *bgSubstractor;
+            tmd::DetectionStage *detectionStage;
+            tmd::BoundedQueue<tmd::frame_t*> *output;
+            std::thread worker;
+        } camera_t;
+
+        /**
+         * Method executed by the thread of the given camera.
+         */
+        void run_camera(camera_t *camera);
+
+        std::vector<camera_t*> m_cameras;
+        std::atomic<bool> m_stop_request;
+        bool m_done;
+    };
+}
+
+#endif //BACHELOR_PROJECT_MULTI_CAMERA_PIPELINE_H
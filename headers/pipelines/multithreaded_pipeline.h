@@ -1,5 +1,7 @@
 #include "pipeline.h"
 #include "pipeline_thread.h"
+#include "frame_decoder.h"
+#include "../misc/reorder_buffer.h"
 
 #ifndef BACHELOR_PROJECT_MULTITHREADED_PIPELINE_H
 #define BACHELOR_PROJECT_MULTITHREADED_PIPELINE_H
@@ -7,9 +9,15 @@
 namespace tmd{
     /**
      * Class reprensenting a multithreaded pipeline.
-     * The threads are scheduled in a fine-grained way :
-     * Frame index : s s+1 s+2 s+3 ... e
-     * Thread :      0  1   2   3  ... x
+     * The video is decoded only once, by a FrameDecoder. Each thread takes
+     * the next decoded frame as soon as it is done with its previous one, so
+     * a costly frame does not hold back the other threads. The computed
+     * frames are put back in order by a ReorderBuffer.
+     *
+     * Note that each thread has its own background model. With a positive
+     * Config::bgs_update_interval, every model is also given the frames
+     * updating the models which it doesn't compute itself (skipped ones
+     * included), through its own update output of the decoder.
      */
     class MultithreadedPipeline : public Pipeline{
 
@@ -39,14 +47,31 @@ namespace tmd{
          */
         frame_t* next_frame();
 
+        /**
+         * Stop the threads and the decoder. Any call to next_frame(),
+         * including one currently waiting, then returns NULL.
+         */
+        void stop();
+
+        /**
+         * Change the step size. It applies from the next decoded frame.
+         */
+        void set_step_size(int step_size);
+
+        /**
+         * Returns the average time, in seconds, a thread spent on one frame
+         * since the last call, or 0 if no frame has been computed.
+         */
+        double get_mean_processing_time();
+
     private:
         void schedule_threads(std::string video_folder);
 
+        tmd::FrameDecoder *m_decoder; // Shared decoding stage.
+        tmd::ReorderBuffer<tmd::frame_t*> *m_results; // Computed frames.
         tmd::PipelineThread** m_pipeline_threads; // The threads.
         int m_thread_count;
-        int m_frame_pos; // Current frame index.
-        int m_next_thread_to_use; // Keep track of the next thread we should
-                                    // use to get the next frame.
+        bool m_done;
     };
 }
 
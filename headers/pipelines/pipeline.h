@@ -32,7 +32,7 @@ namespace tmd{
          Pipeline(std::string video_folder, int camera_index, int start_frame,
                   int end_frame, int step_size);
 
-        ~Pipeline();
+        virtual ~Pipeline();
 
         /**
          * Extract the next frame from the input video.
@@ -47,9 +47,7 @@ namespace tmd{
 
     protected:
 
-        cv::VideoCapture *m_video;
-
-        std::string m_video_path;
+        std::string m_video_folder;
         int m_camera_index;
         int m_step;
         int m_start;
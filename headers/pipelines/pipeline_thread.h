@@ -2,14 +2,13 @@
 #define BACHELOR_PROJECT_PIPELINE_THREAD_H
 
 #include <string>
-#include <deque>
 #include <vector>
-#include <mutex>
 #include <thread>
 #include <atomic>
 #include "../data_structures/player_t.h"
 #include "pipeline.h"
 #include "../misc/debug.h"
+#include "../misc/reorder_buffer.h"
 #include "simple_pipeline.h"
 
 namespace tmd{
@@ -17,6 +16,10 @@ namespace tmd{
      * Class representing a thread running  a pipeline.
      * This thread is completely independent form the main thread so that it
      * only computes the frames and put them in a buffer.
+     *
+     * The threads of a MultithreadedPipeline all take their frames from the
+     * same decoder output, whenever they are ready for a new one, and put
+     * them back in a shared ReorderBuffer, using their sequence index.
      */
     class PipelineThread{
     public:
@@ -25,50 +28,50 @@ namespace tmd{
          * video_folder : Folder containing the video.
          * camera_index : The camera index.
          * thread_id : The id of this thread.
-         * start_frame : The index of the first frame to begin.
+         * start_frame : The index of the first frame decoded.
          * end_frame : The index of the last frame to compute.
-         * step_size : The "distance" between to consecutive frames.
+         * step_size : The "distance" between to consecutive decoded frames.
+         * decoder : The decoder providing the frames, on its output 0, and
+         * the update frames on its update output thread_id, if any.
+         * output : The buffer receiving the computed frames.
          */
         PipelineThread(std::string video_folder, int camera_index, int thread_id
-                , int starting_frame, int ending_frame, int step_size);
+                , int starting_frame, int ending_frame, int step_size,
+                tmd::FrameDecoder *decoder,
+                tmd::ReorderBuffer<tmd::frame_t*> *output);
 
         /**
-         * Destructor of the PipelineThread.
+         * Destructor of the PipelineThread. Waits for the working thread.
+         * The decoder output and the ReorderBuffer have to be closed before,
+         * so that the thread is not waiting on one of them.
          */
         ~PipelineThread();
 
         /**
-         * Get the top of the buffer (ie the oldest entry).
-         * /!\ Can lead to waiting time due to dependencies between the
-         * caller and *this.
+         * Get the time spent computing frames (without waiting for the
+         * decoder) and the number of frames computed since the last call.
          */
-        tmd::frame_t* pop_buffer();
+        void take_processing_stats(double &busy_time, int &frame_count);
 
     private:
         /**
          * Method executed by the working thread.
          */
         void extract_from_pipeline();
-        /**
-         * Add data to the end of the buffer.
-         * Only used by the working thread.
-         */
-        void push_buffer(tmd::frame_t* frame);
 
-        tmd::Pipeline *m_pipeline; // The pipeline used.
+        tmd::SimplePipeline *m_pipeline; // The pipeline used.
+        tmd::FrameDecoder *m_decoder;
+        tmd::ReorderBuffer<tmd::frame_t*> *m_output;
         std::thread m_worker; // The actual thread.
-        std::deque<tmd::frame_t* > m_buffer;
-        std::mutex m_buffer_lock;
 
         int m_starting_frame;
         int m_ending_frame;
-        int m_frame_idx;
         int m_step_size;
         int m_id;
-        bool m_done;
 
         std::atomic<bool> m_stop_request;
-        std::atomic<bool> m_worker_stopped;
+        std::atomic<long long> m_busy_ticks;
+        std::atomic<int> m_frames_done;
     };
 }
 
@@ -0,0 +1,90 @@
+#ifndef BACHELOR_PROJECT_REAL_TIME_CONTROLLER_H
+#define BACHELOR_PROJECT_REAL_TIME_CONTROLLER_H
+
+#include <string>
+#include "../misc/config.h"
+#include "../features_extraction/dpm.h"
+#include "../players_extraction/blob_based_extraction/blob_player_extractor.h"
+
+namespace tmd{
+
+    /**
+     * Class tuning the ApproximativePipeline so that the boxes keep up with
+     * the video.
+     *
+     * For every set of boxes, the pipeline reports how late the boxes are on
+     * the display and how long a thread spent on one frame. Every
+     * Config::controller_window sets, the controller compares the average
+     * with the time available per frame (box step / FPS, for each thread) :
+     *  - If the boxes are too late, it first ignores more small blobs,
+     *    then refreshes the boxes less often, and finally gives the DPM
+     *    more threads, up to Config::controller_max_dpm_threads (by
+     *    default, one per core).
+     *  - If there is enough time left, it undoes these in reverse order,
+     *    without going below the initial settings.
+     * Only one setting changes at a time and every change is logged.
+     *
+     * The settings are given to the extractors through
+     * BlobPlayerExtractor::set_min_blob_size() and DPM::set_thread_count(),
+     * which the threads computing the boxes can read at the same time. The
+     * Config is left untouched.
+     */
+    class RealTimeController{
+    public:
+        /**
+         * Constructor of the controller.
+         * fps : The frame rate of the video.
+         * box_step : The initial number of frames between two box refreshes.
+         * thread_count : The number of threads computing the boxes.
+         */
+        RealTimeController(double fps, int box_step, int thread_count);
+
+        /**
+         * Add the measure of one set of boxes.
+         * processing_time : The average time, in seconds, a thread spent on
+         * one frame.
+         * lag : The time, in seconds, the display is ahead of the boxes.
+         * Returns true if the box step has been changed.
+         */
+        bool add_measure(double processing_time, double lag);
+
+        /**
+         * Returns the number of frames between two box refreshes.
+         */
+        int get_box_step();
+
+    private:
+        /**
+         * Fraction of the available time used with the given box step.
+         */
+        double load_for_step(int box_step);
+
+        /**
+         * Returns the maximum number of threads of the DPM.
+         */
+        int get_max_dpm_threads();
+
+        /**
+         * Print an adjustment on the standard output.
+         */
+        void log(const std::string &setting, int old_value, int new_value);
+
+        double m_fps;
+        int m_thread_count;
+
+        int m_box_step;
+        int m_blob_size;
+        int m_dpm_threads;
+        int m_min_box_step; // The initial settings.
+        int m_min_blob_size;
+        int m_min_dpm_threads;
+
+        int m_measure_count;
+        double m_processing_sum;
+        double m_lag_sum;
+        double m_last_lag;
+        double m_last_processing_time;
+    };
+}
+
+#endif //BACHELOR_PROJECT_REAL_TIME_CONTROLLER_H
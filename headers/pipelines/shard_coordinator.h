@@ -0,0 +1,78 @@
+#ifndef BACHELOR_PROJECT_SHARD_COORDINATOR_H
+#define BACHELOR_PROJECT_SHARD_COORDINATOR_H
+
+#include <string>
+#include <vector>
+#include <sys/types.h>
+#include <opencv2/highgui/highgui.hpp>
+#include "../misc/config.h"
+#include "../misc/debug.h"
+
+namespace tmd{
+
+    /**
+     * Class splitting the frames [start_frame, end_frame] of a video into
+     * several chunks (shards) and computing each of them in its own process.
+     * A crash of a process (e.g. in the DPM) thus only loses its own chunk.
+     *
+     * Each process is the program itself, started with "--shard-output
+     * <prefix>" : it computes its chunk on a single thread, writes its
+     * results in <prefix>.log and <prefix>.avi, and gives the
+     * Config::bgs_warmup_frames frames before its chunk to the background
+     * model without computing them. The processes only restore the
+     * snapshots of the background model (see --no-checkpoints) : their
+     * models did not see the whole video.
+     * Once every process is done, their logs and videos are merged, in the
+     * order of the frames.
+     */
+    class ShardCoordinator{
+    public:
+        /**
+         * Constructor of the coordinator.
+         * program : The name of the program, as given in argv[0].
+         * shard_count : The number of processes.
+         * The other arguments are the ones of the pipelines.
+         */
+        ShardCoordinator(const std::string &program,
+                         const std::string &video_folder, int camera_index,
+                         int start_frame, int end_frame, int step_size,
+                         int shard_count);
+
+        /**
+         * Start the processes, wait for them, and merge their results into
+         * the given files ("" to not produce the file).
+         * Returns false if a process failed, in which case nothing is
+         * merged and the results of the shards are kept.
+         */
+        bool run(const std::string &log_path, const std::string &video_path);
+
+    private:
+        typedef struct{
+            int start_frame;
+            int end_frame;
+            std::string output; // Prefix of the result files.
+            pid_t pid;
+        } shard_t;
+
+        /**
+         * Start the process of the given shard. Its standard output goes to
+         * <output>.out.
+         */
+        bool start_shard(shard_t &shard);
+
+        /**
+         * Concatenate the logs / videos of the shards.
+         */
+        bool merge_logs(const std::string &log_path);
+        bool merge_videos(const std::string &video_path);
+
+        std::string m_program;
+        std::string m_executable; // Resolved path, "" if unknown.
+        std::string m_video_folder;
+        int m_camera_index;
+        int m_step_size;
+        std::vector<shard_t> m_shards;
+    };
+}
+
+#endif //BACHELOR_PROJECT_SHARD_COORDINATOR_H
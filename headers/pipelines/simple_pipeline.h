@@ -2,7 +2,8 @@
 #define BACHELOR_PROJECT_SIMPLE_PIPELINE_H
 
 #include "pipeline.h"
-#include "../players_extraction/blob_based_extraction/blob_separator.h"
+#include "frame_decoder.h"
+#include "detection_stage.h"
 
 namespace tmd{
     /**
@@ -22,6 +23,25 @@ namespace tmd{
         SimplePipeline(std::string video_folder, int camera_index,
                        int start_frame, int end_frame, int step_size);
 
+        /**
+         * Constructor of a Simple Pipeline which does not read the video
+         * itself but takes its frames from one of the outputs of a
+         * FrameDecoder.
+         * video_folder : Folder containing the video.
+         * camera_index : The camera index.
+         * start_frame : The index of the first frame to begin.
+         * end_frame : The index of the last frame to compute.
+         * step_size : The "distance" between to consecutive frames.
+         * decoder : The decoder providing the frames.
+         * decoder_output : The index of the decoder output to use.
+         * update_output : The index of the decoder update output giving the
+         * frames of the other pipelines to the model, -1 if none.
+         */
+        SimplePipeline(std::string video_folder, int camera_index,
+                       int start_frame, int end_frame, int step_size,
+                       tmd::FrameDecoder *decoder, int decoder_output,
+                       int update_output = -1);
+
         /**
          * Destructor of the Simple pipeline.
          */
@@ -32,6 +52,13 @@ namespace tmd{
          */
         frame_t* next_frame();
 
+        /**
+         * Returns the time spent computing frames since the last call, in
+         * ticks (see cv::getTickCount()). The time spent waiting for the
+         * decoder is not counted.
+         */
+        long long take_compute_ticks();
+
         /**
          * Sets the properties of the bgs.
          */
@@ -40,15 +67,18 @@ namespace tmd{
 
     private:
         /**
-         * Extract the players from the given frames, and set their property
-         * (team, features, ...)
+         * Give the model the update frames of the update output which come
+         * before the given frame. The copy of the frame itself is dropped.
          */
-        void extract_players_from_frame(tmd::frame_t* frame);
+        void apply_updates(int frame_index);
 
+        tmd::BoundedQueue<tmd::frame_t*> *m_input; // NULL if the bgs reads
+                                                    // the video itself.
+        tmd::BoundedQueue<tmd::frame_t*> *m_updates; // NULL if none.
+        tmd::frame_t *m_next_update; // Popped, after the current frame.
         tmd::BGSubstractor      *m_bgSubstractor;
-        tmd::PlayerExtractor    *m_playerExtractor;
-        tmd::FeaturesExtractor  *m_featuresExtractor;
-        tmd::FeatureComparator  *m_featuresComparator;
+        tmd::DetectionStage     *m_detectionStage;
+        long long m_compute_ticks;
     };
 }
 
@@ -0,0 +1,82 @@
+#ifndef BACHELOR_PROJECT_STAGED_PIPELINE_H
+#define BACHELOR_PROJECT_STAGED_PIPELINE_H
+
+#include <vector>
+#include <thread>
+#include <atomic>
+#include <utility>
+#include "pipeline.h"
+#include "detection_stage.h"
+#include "../misc/bounded_queue.h"
+#include "../misc/reorder_buffer.h"
+
+namespace tmd{
+    /**
+     * Class representing a multithreaded pipeline split in two stages :
+     *      _ The decoding and the background subtraction run on one thread,
+     *      in the order of the video, exactly as in the SimplePipeline.
+     *      _ The rest of the algorithm (see DetectionStage) runs on
+     *      thread_count threads, each one taking the next frame available.
+     * The frames are then put back in order before being returned.
+     *
+     * As there is only one background model, which sees every frame, the
+     * results are the same as the ones of the SimplePipeline, whatever the
+     * thread count is.
+     */
+    class StagedPipeline : public Pipeline{
+
+    public:
+        /**
+         * Constructor of the Staged Pipeline.
+         * video_folder : Folder containing the video.
+         * camera_index : The camera index.
+         * thread_count : The number of threads running the detection.
+         * start_frame : The index of the first frame to begin.
+         * end_frame : The index of the last frame to compute.
+         * step_size : The "distance" between to consecutive frames.
+         */
+        StagedPipeline(std::string video_folder, int camera_index,
+                       int thread_count, int start_frame, int end_frame,
+                       int step_size);
+
+        /**
+         * Destructor of the Staged Pipeline. Stops every thread.
+         */
+        ~StagedPipeline();
+
+        /**
+         * Returns the next frame, in the order of the video.
+         * If there is no frame left the method simply returns NULL.
+         *
+         * Note that the user has to take care of freeing the frames.
+         */
+        frame_t* next_frame();
+
+    private:
+        /**
+         * Method executed by the background subtraction thread.
+         */
+        void run_bgs_stage();
+
+        /**
+         * Method executed by the detection threads.
+         */
+        void run_detection_stage(int thread_id);
+
+        tmd::BGSubstractor *m_bgSubstractor;
+        std::vector<tmd::DetectionStage*> m_detection_stages;
+
+        // Frames which went through the BGS, with their sequence number.
+        tmd::BoundedQueue<std::pair<long, tmd::frame_t*>> *m_masked_frames;
+        // Frames which went through the whole algorithm.
+        tmd::ReorderBuffer<tmd::frame_t*> *m_results;
+
+        std::thread m_bgs_worker;
+        std::vector<std::thread> m_detection_workers;
+
+        std::atomic<bool> m_stop_request;
+        bool m_done;
+    };
+}
+
+#endif //BACHELOR_PROJECT_STAGED_PIPELINE_H
@@ -0,0 +1,125 @@
+#ifndef BACHELOR_PROJECT_BLOB_LABELER_H
+#define BACHELOR_PROJECT_BLOB_LABELER_H
+
+#include <vector>
+#include <opencv2/core/core.hpp>
+#include "../../background_subtractor/packed_mask.h"
+
+namespace tmd{
+
+    /**
+     * Structure representing the foreground pixels [begin, end[ of a row.
+     */
+    typedef struct{
+        int row;
+        int begin;
+        int end;
+    } run_t;
+
+    /**
+     * Structure representing a blob : its bounding box and its number of
+     * pixels.
+     */
+    typedef struct{
+        cv::Rect box;
+        int area;
+    } blob_t;
+
+    /**
+     * Connected component labeling of a packed mask. Two foreground pixels
+     * are connected if they are at most "radius" rows and "radius" columns
+     * away from each other (the pixels of a row next to each other are
+     * always connected, even with a radius of 0).
+     *
+     * The mask is read as horizontal runs of foreground pixels, found a word
+     * at a time. The runs close enough to each other are merged with a
+     * union-find on a flat array, and the area and the bounding box of
+     * every blob are computed from its runs.
+     *
+     * The rows are cut in horizontal strips, one per thread of the pool,
+     * whose runs are found and merged in parallel. The strips are then
+     * merged through the radius first rows of each of them, which gives the
+     * same blobs, in the same order, as a single strip.
+     *
+     * The rows can also be given one at a time, as soon as they are known
+     * (see start()), on the calling thread.
+     */
+    class BlobLabeler{
+    public:
+        /**
+         * Returns the blobs of the foreground pixels of the mask inside of
+         * roi, in the order of their first pixel (row by row).
+         */
+        std::vector<tmd::blob_t> label(const tmd::PackedMask &mask,
+                                       const cv::Rect &roi, int radius);
+
+        /**
+         * Start labeling the rows of roi (which must be inside of the
+         * mask), which are then given in order to add_row(). finish()
+         * returns the same blobs as label().
+         */
+        void start(const cv::Rect &roi, int radius);
+
+        /**
+         * Label the next row of the roi, whose runs are merged with the ones
+         * of the previous rows right away.
+         * words : The row of the packed mask (see PackedMask::get_row()).
+         */
+        void add_row(const uint64_t *words);
+
+        /**
+         * Returns the blobs of the rows given since start() (or label()).
+         */
+        std::vector<tmd::blob_t> finish();
+
+    private:
+        /**
+         * Fill "runs" with the runs of the rows of roi, and "row_start" with
+         * the index of the first run of each of these rows (and the number
+         * of runs at the end).
+         */
+        void find_runs(const tmd::PackedMask &mask, const cv::Rect &roi,
+                       std::vector<tmd::run_t> &runs,
+                       std::vector<int> &row_start);
+
+        /**
+         * Append to "runs" the runs of the columns [begin, end[ of the given
+         * row, whose words are "words".
+         */
+        void find_row_runs(const uint64_t *words, int row, int begin, int end,
+                           std::vector<tmd::run_t> &runs);
+
+        /**
+         * Merge the runs of the row (relative to the roi) which are close
+         * enough to each other.
+         */
+        void connect_row(int row, int radius);
+
+        /**
+         * Merge the runs of the row with the runs of the rows [begin, end[
+         * whose columns, widened by radius, overlap their own.
+         */
+        void connect_rows(int row, int begin, int end, int radius);
+
+        /**
+         * Returns the first run of the blob of the given run.
+         */
+        int find(int run);
+
+        /**
+         * Merge the blobs of the two runs.
+         */
+        void unite(int a, int b);
+
+        // Kept from a call to the next one to reuse their memory.
+        std::vector<tmd::run_t> m_runs; // Sorted by row, then column.
+        std::vector<int> m_row_start; // First run of each row of the roi.
+        std::vector<int> m_parent;
+        std::vector<std::vector<tmd::run_t>> m_strip_runs;
+        std::vector<std::vector<int>> m_strip_row_start;
+        cv::Rect m_roi; // Of the rows given to add_row().
+        int m_radius;
+    };
+}
+
+#endif //BACHELOR_PROJECT_BLOB_LABELER_H
@@ -1,10 +1,10 @@
 #ifndef BACHELOR_PROJECT_BLOB_PLAYER_EXTRACTOR_H
 #define BACHELOR_PROJECT_BLOB_PLAYER_EXTRACTOR_H
 
-#include <set>
 #include <iostream>
 #include "../../misc/config.h"
 #include "../player_extractor.h"
+#include "blob_labeler.h"
 
 namespace tmd{
 
@@ -23,11 +23,20 @@ namespace tmd{
         virtual std::vector<player_t*> extract_player_from_frame(frame_t*
         frame);
 
-    private :
         /**
-         * Clamp the results according to the given limits.
+         * Set the minimum size of the blobs kept by all the extractors,
+         * instead of Config::blob_player_extractor_min_blob_size. It can be
+         * called while other threads extract players.
+         */
+        static void set_min_blob_size(int size);
+
+        /**
+         * Returns the minimum size of the blobs kept by the extractors.
          */
-        bool clamp(int rows, int cols, int row, int col);
+        static int get_min_blob_size();
+
+    private :
+        tmd::BlobLabeler m_labeler;
     };
 }
 
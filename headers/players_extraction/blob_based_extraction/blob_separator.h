@@ -17,10 +17,22 @@ namespace tmd{
         /**
          *  Separates the blobs (represented by players). And returns the new
          *  vector containing this time the players of the original frame.
+         *
+         *  The blobs are handled in parallel on the shared ThreadPool, the
+         *  biggest ones first. The returned players are in the same order as
+         *  if the blobs had been handled one after the other.
          */
         static std::vector<tmd::player_t*> separate_blobs
                 (std::vector<tmd::player_t*> players);
+
+    private:
+        /**
+         * Run the DPM on one blob and returns the players it contains, with
+         * their position relative to the original frame.
+         * The blob itself is not freed.
+         */
+        static std::vector<tmd::player_t*> separate_blob(tmd::player_t *blob);
     };
 }
 
-#endif //BACHELOR_PROJECT_BLOB_SEPARATOR_H
\ No newline at end of file
+#endif //BACHELOR_PROJECT_BLOB_SEPARATOR_H
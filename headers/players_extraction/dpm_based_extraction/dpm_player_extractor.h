@@ -31,7 +31,7 @@ namespace tmd{
         frame);
 
         /**
-         * Setters for the 2 thresholds.
+         * Setters for the 2 thresholds, used from the next detection on.
          */
         void set_overlapping_threshold(float th);
         void set_score_threshold(float th);
@@ -43,7 +43,6 @@ namespace tmd{
         float get_score_threshold();
 
     private:
-        void recreate_detector();
         tmd::DPM* m_detector;
     };
 }
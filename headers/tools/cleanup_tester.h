@@ -0,0 +1,49 @@
+#ifndef BACHELOR_PROJECT_CLEANUP_TESTER_H
+#define BACHELOR_PROJECT_CLEANUP_TESTER_H
+
+#include <iostream>
+#include <random>
+#include <opencv2/core/core.hpp>
+#include "../background_subtractor/bgsubstractor.h"
+#include "../misc/config.h"
+
+namespace tmd{
+
+    /**
+     * Class checking the cleanup of the masks of the BGSubstractor (see
+     * BGSubstractor::stream_mask()) against the loops it replaced, which
+     * counted the foreground pixels around every pixel close to the
+     * foreground (count_neighbours_in_fg()). Random masks with shadows
+     * (127), random static masks, buffer sizes and thresholds are used.
+     *
+     * The BGSubstractor is built with the static mask of the camera 0 (see
+     * Config::mask_folder), which is then replaced by the random ones.
+     */
+    class CleanupTester{
+    public:
+        /**
+         * Check the cleanup on the given number of random masks, generated
+         * from the given seed. The mismatches are written on the standard
+         * output.
+         * Returns true if every mask gave the mask of the former loops.
+         */
+        static bool test_cleanup(int mask_count, unsigned int seed);
+
+    private:
+        /**
+         * The former cleanup of "mask" (CV_8U), in place. The static mask
+         * is already applied to it.
+         */
+        static void clean_mask(cv::Mat &mask, int buffer_size,
+                               int count_threshold);
+
+        /**
+         * Returns the number of non zero pixels at most buffer_size pixels
+         * away from (x, y), outside of the first row and column.
+         */
+        static int count_neighbours_in_fg(const cv::Mat &mask, int x, int y,
+                                          int buffer_size);
+    };
+}
+
+#endif //BACHELOR_PROJECT_CLEANUP_TESTER_H
@@ -0,0 +1,45 @@
+#ifndef BACHELOR_PROJECT_LABELER_TESTER_H
+#define BACHELOR_PROJECT_LABELER_TESTER_H
+
+#include <iostream>
+#include <random>
+#include <opencv2/core/core.hpp>
+#include "../players_extraction/blob_based_extraction/blob_labeler.h"
+#include "../misc/config.h"
+
+namespace tmd{
+
+    /**
+     * Class checking the BlobLabeler against a flood fill, on random masks
+     * and rois. Both the strips of label() and the rows given one at a time
+     * to add_row() are checked, with radii from 0 to 8.
+     */
+    class LabelerTester{
+    public:
+        /**
+         * Check the labeler on the given number of random masks, generated
+         * from the given seed. The mismatches are written on the standard
+         * output.
+         * Returns true if every mask gave the blobs of the flood fill.
+         */
+        static bool test_labeler(int mask_count, unsigned int seed);
+
+    private:
+        /**
+         * Returns the blobs of the non zero pixels of "mask" (CV_8U) inside
+         * of roi, found with a flood fill, in the order of their first pixel.
+         */
+        static std::vector<tmd::blob_t> flood_fill(const cv::Mat &mask,
+                                                   const cv::Rect &roi,
+                                                   int radius);
+
+        /**
+         * Returns whether the two lists contain the same blobs, in the same
+         * order.
+         */
+        static bool same_blobs(const std::vector<tmd::blob_t> &a,
+                               const std::vector<tmd::blob_t> &b);
+    };
+}
+
+#endif //BACHELOR_PROJECT_LABELER_TESTER_H
@@ -0,0 +1,25 @@
+#include "../../headers/background_subtractor/bgs_engine.h"
+#include "../../headers/background_subtractor/parallel_mog2.h"
+#include "../../headers/background_subtractor/static_background_engine.h"
+
+namespace tmd {
+    BGSEngine::~BGSEngine() {
+    }
+
+    BGSEngine *BGSEngine::create() {
+        const std::string &type = tmd::Config::bgs_engine;
+        tmd::debug("BGSEngine", "create", "Creating a " + type + " engine.");
+        if (type == "mog2") {
+            return new ParallelMOG2(tmd::Config::bgs_history,
+                                    tmd::Config::bgs_threshold,
+                                    tmd::Config::bgs_detect_shadows);
+        }
+        else if (type == "static") {
+            return new StaticBackgroundEngine(
+                    tmd::Config::bgs_static_threshold_blue,
+                    tmd::Config::bgs_static_threshold_green,
+                    tmd::Config::bgs_static_threshold_red);
+        }
+        throw std::invalid_argument("Error : unknown bgs engine " + type);
+    }
+}
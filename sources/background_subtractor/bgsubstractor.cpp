@@ -1,76 +1,117 @@
 #include "../../headers/background_subtractor/bgsubstractor.h"
+#include "../../headers/frame_sources/prefetch_frame_source.h"
+#include <algorithm>
+#include <cmath>
+#include <cstring>
 
 namespace tmd {
     BGSubstractor::BGSubstractor(std::string video_folder, int camera_index, int
     starting_frame, int ending_frame, int step_size) {
-        m_bgs = new cv::BackgroundSubtractorMOG2(tmd::Config::bgs_history,
-                                                 tmd::Config::bgs_threshold,
-                                                 tmd::Config::bgs_detect_shadows);
         m_starting_frame = starting_frame;
         m_ending_frame = ending_frame;
         m_step_size = step_size;
 
-
-        m_learning_rate = tmd::Config::bgs_learning_rate;
-        tmd::debug("BGSubstractor", "BGSubstractor", "bgs created.");
-
-        m_input_video_path = video_folder + "ace_" + std::to_string
-                (camera_index) + ".mp4";
-
-        std::string mask_path = tmd::Config::mask_folder + "mask_ace" +
-                                std::to_string(camera_index) + ".jpg";
-        m_static_mask = cv::imread(mask_path, 0);
+        m_source = tmd::FrameSource::open(video_folder, camera_index);
 
         // Take the first frame of the video and take it as the background
         // model.
-        m_input_video.open(m_input_video_path);
-        if (!m_input_video.isOpened()) {
-            throw std::invalid_argument("Error in BGSubstractor constructor, "
-                                                "input video is not valid (NULL or not opened).");
+        cv::Mat first_frame;
+        if (!tmd::Config::use_empty_room_images_as_background){
+            first_frame = m_source->get_first_frame();
         }
+        init_model(camera_index, first_frame);
 
-        cv::Mat bg;
-        if (tmd::Config::use_empty_room_images_as_background){
-            bg = cv::imread(tmd::Config::bgs_empty_room_background + "/ace_" +
-                            std::to_string(camera_index) + ".jpg");
-        }
-        else{
-            m_input_video.read(bg);
-        }
-        cv::Mat mask;
-        m_bgs->operator()(bg, mask, m_learning_rate);
+        const bool fixed_updates = tmd::Config::bgs_update_interval > 0;
+        const bool whole_history = catch_up(m_starting_frame);
+
+        // The snapshots are the models of a reader going through every
+        // frame of the video : without fixed updates, the skipped frames
+        // would be missing from the model.
+        m_saves_checkpoints = whole_history &&
+                              (m_step_size == 1 || fixed_updates);
 
-        m_input_video.open(m_input_video_path);
-        m_input_video.set(CV_CAP_PROP_POS_FRAMES, m_starting_frame);
-        if (!m_input_video.isOpened()) {
+        if (!m_source->seek(m_starting_frame)) {
+            delete m_source;
             throw std::invalid_argument("Error in BGSubstractor constructor, "
-                                                "input video is not valid (NULL or not opened).");
+                                                "can not reach the starting frame.");
+        }
+        m_images_per_step = m_step_size;
+        if (tmd::Config::frame_source_prefetch_size > 0) {
+            // The skipped frames are dropped by the prefetching source,
+            // unless some of them update the model.
+            const bool keep_skipped = fixed_updates && m_step_size > 1;
+            m_source = new tmd::PrefetchFrameSource(
+                    m_source, keep_skipped ? 1 : m_step_size,
+                    tmd::Config::frame_source_prefetch_size);
+            m_images_per_step = keep_skipped ? m_step_size : 1;
         }
 
         tmd::debug("BGSubstractor", "BGSubstractor", "valid input video.");
+        m_frame_index = m_starting_frame;
+        m_total_frame_count = m_source->get_frame_count();
+        tmd::debug("BGSubstractor", "BGSubstractor", "m_total_frame_count = "
+                                                     + std::to_string(m_total_frame_count));
+        tmd::debug("BGSubstractor", "BGSubstractor", "exiting method");
+    }
+
+    BGSubstractor::BGSubstractor(const cv::Mat &first_frame, int
+    camera_index) {
+        m_starting_frame = 0;
+        m_ending_frame = -1;
+        m_step_size = 1;
+        m_frame_index = 0;
+        m_total_frame_count = 0;
+        m_source = NULL;
+        m_images_per_step = 1;
+        // The frames given may not be all the frames of the video.
+        m_saves_checkpoints = false;
+        init_model(camera_index, first_frame);
+    }
+
+    void BGSubstractor::init_model(int camera_index, const cv::Mat
+    &first_frame) {
+        m_bgs = tmd::BGSEngine::create();
+        m_learning_rate = tmd::Config::bgs_learning_rate;
+        tmd::debug("BGSubstractor", "BGSubstractor", "bgs created.");
+
         m_camera_index = camera_index;
         if (!(0 <= m_camera_index && m_camera_index < 8)) {
             throw std::invalid_argument("Error in BGSubstractor constructor, "
                                                 "invalid camera index " +
-                                        m_camera_index);
+                                        std::to_string(m_camera_index));
         }
-
         tmd::debug("BGSubstractor", "BGSubstractor", "valid camera index");
-        m_frame_index = m_starting_frame;
-        m_total_frame_count = (m_input_video.get(CV_CAP_PROP_FRAME_COUNT));
-        tmd::debug("BGSubstractor", "BGSubstractor", "m_total_frame_count = "
-                                                     + std::to_string(m_total_frame_count));
-        tmd::debug("BGSubstractor", "BGSubstractor", "exiting method");
+
+        std::string mask_path = tmd::Config::mask_folder + "mask_ace" +
+                                std::to_string(camera_index) + ".jpg";
+        m_static_mask = tmd::AssetRegistry::get_instance()->get_image(
+                mask_path, 0);
+        m_cleanup_radius = -1;
+        m_downscale_factor = std::max(1, tmd::Config::bgs_downscale_factor);
+        update_region();
+
+        cv::Mat bg;
+        if (tmd::Config::use_empty_room_images_as_background){
+            bg = tmd::AssetRegistry::get_instance()->get_image(
+                    tmd::Config::bgs_empty_room_background + "/ace_" +
+                    std::to_string(camera_index) + ".jpg");
+        }
+        else{
+            bg = first_frame;
+        }
+        cv::Mat mask;
+        m_bgs->apply(reduce(bg), mask, m_learning_rate);
     }
 
     BGSubstractor::~BGSubstractor() {
-        // cv::Ptr free the bgs for us.
-        m_input_video.release();
+        delete m_bgs;
+        delete m_source;
     }
 
     frame_t *BGSubstractor::next_frame() {
         frame_t *frame = new frame_t;
-        bool frame_extracted = m_input_video.read(frame->original_frame);
+        bool frame_extracted = m_source != NULL &&
+                               m_source->read(frame->original_frame);
         if (!frame_extracted || m_frame_index > m_ending_frame) {
             tmd::debug("BGSubstractor", "next_frame", "No frame left, "
                                                               "returning NULL after " + std::to_string(m_frame_index) +
@@ -79,91 +120,324 @@ namespace tmd {
             return NULL;
         }
         frame->frame_index = m_frame_index;
-        m_bgs->operator()(frame->original_frame,
-                          frame->mask_frame,
-                          m_learning_rate);
+        process_frame(frame);
+        step();
+        return frame;
+    }
+
+    frame_t *BGSubstractor::process_frame(frame_t *frame) {
+        if (frame->update_only) {
+            cv::Mat mask;
+            m_bgs->apply(reduce(frame->original_frame), mask,
+                         m_learning_rate);
+            return frame;
+        }
+
+        // The frames which don't update the model are only classified.
+        cv::Mat mask;
+        m_bgs->apply(reduce(frame->original_frame), mask,
+                     is_update_frame(frame->frame_index) ? m_learning_rate :
+                     0);
         frame->camera_index = m_camera_index;
 
-        //applying static frame
-        for (int row = 0; row < m_static_mask.rows; row++) {
-            for (int col = 0; col < m_static_mask.cols; col++) {
-                if (m_static_mask.at<uchar>(row, col) == 0) {
-                    frame->mask_frame.at<uchar>(row, col) = 0;
-                }
-            }
+        const int interval = tmd::Config::bgs_checkpoint_interval;
+        if (m_saves_checkpoints && tmd::Config::bgs_save_checkpoints &&
+            interval > 0 &&
+            frame->frame_index % interval == 0) {
+            save_checkpoint(frame->frame_index);
         }
 
-        //second pass : "Reduce" the resolution of the mask image.
-        cv::Mat mask_copy(m_static_mask.rows, m_static_mask.cols, CV_8U);
-        cv::Mat checked_pixels;
-        checked_pixels = cv::Mat::zeros(m_static_mask
-                                                .rows, m_static_mask.cols, CV_8U);
-        frame->mask_frame.copyTo(mask_copy);
-        int buffer_size = tmd::Config::bgs_blob_buffer_size;
-        int count_threshold = tmd::Config::bgs_blob_threshold_count;
-
-        for (int row = 0; row < m_static_mask.rows; row++) {
-            for (int col = 0; col < m_static_mask.cols; col++) {
-                int current_value = frame->mask_frame.at<uchar>(row, col);
-                if (current_value != 0) {
-                    for (int neighbour_col = -buffer_size; neighbour_col <= buffer_size; neighbour_col++) {
-                        for (int neighbour_row = -buffer_size; neighbour_row <= buffer_size; neighbour_row++) {
-                            if (col + neighbour_col > 0 && col + neighbour_col < m_static_mask.cols
-                                && row + neighbour_row > 0 && row + neighbour_row < m_static_mask.rows) {
-                                if (checked_pixels.at<uchar>(row + neighbour_row, col + neighbour_col) == 0) {
-                                    if (count_neighbours_in_fg(frame->mask_frame, col + neighbour_col,
-                                                               row + neighbour_row, buffer_size) > count_threshold) {
-                                        mask_copy.at<uchar>(row + neighbour_row, col + neighbour_col) = 255;
-                                    }
-                                    else {
-                                        mask_copy.at<uchar>(row + neighbour_row, col + neighbour_col) = 0;
-                                    }
-                                    checked_pixels.at<uchar>(row + neighbour_row, col + neighbour_col) = 255;
-                                }
-                            }
-                        }
-                    }
+        stream_mask(mask, frame);
+        if (m_static_mask.empty()) {
+            return frame;
+        }
+
+        // The foreground is inside of the cleanup region, in pixels of the
+        // frame.
+        const cv::Rect box = get_cleanup_region().get_bounding_box();
+        const int cols = frame->original_frame.cols;
+        const int rows = frame->original_frame.rows;
+        const double scale_x = static_cast<double>(cols) / mask.cols;
+        const double scale_y = static_cast<double>(rows) / mask.rows;
+        const int left = static_cast<int>(box.x * scale_x);
+        const int top = static_cast<int>(box.y * scale_y);
+        const int right = static_cast<int>(
+                std::ceil((box.x + box.width) * scale_x));
+        const int bottom = static_cast<int>(
+                std::ceil((box.y + box.height) * scale_y));
+        frame->mask_roi = cv::Rect(0, 0, cols, rows) &
+                          cv::Rect(left, top, right - left, bottom - top);
+        return frame;
+    }
+
+    cv::Mat BGSubstractor::reduce(const cv::Mat &image) {
+        if (m_downscale_factor == 1 || image.empty()) {
+            return image;
+        }
+        cv::Mat reduced;
+        cv::resize(image, reduced, cv::Size(image.cols / m_downscale_factor,
+                                            image.rows / m_downscale_factor),
+                   0, 0, cv::INTER_AREA);
+        return reduced;
+    }
+
+    void BGSubstractor::update_region() {
+        if (m_static_mask.empty()) {
+            m_bgs->set_region(NULL);
+            return;
+        }
+        cv::Mat static_mask = m_static_mask;
+        if (m_downscale_factor > 1) {
+            cv::resize(m_static_mask, static_mask, cv::Size(
+                    m_static_mask.cols / m_downscale_factor,
+                    m_static_mask.rows / m_downscale_factor), 0, 0,
+                       cv::INTER_NEAREST);
+        }
+        m_region = tmd::MaskRegion(static_mask);
+        m_cleanup_radius = -1;
+        m_bgs->set_region(&m_region);
+
+        const long total = static_cast<long>(static_mask.rows) *
+                           static_mask.cols;
+        tmd::debug("BGSubstractor", "update_region", std::to_string(
+                m_region.get_area()) + " pixels out of " +
+                std::to_string(total) + " in the static mask.");
+    }
+
+    const tmd::MaskRegion &BGSubstractor::get_cleanup_region() {
+        const int buffer_size = tmd::Config::bgs_blob_buffer_size;
+        if (m_cleanup_radius != buffer_size) {
+            m_cleanup_region = m_region.dilate(buffer_size);
+            m_cleanup_radius = buffer_size;
+        }
+        return m_cleanup_region;
+    }
+
+    void BGSubstractor::stream_mask(const cv::Mat &mask,
+                                    tmd::frame_t *frame) {
+        const int rows = mask.rows;
+        const int cols = mask.cols;
+        const bool clean = !m_static_mask.empty() &&
+                           tmd::Config::bgs_blob_buffer_size >= 0;
+        const int buffer_size = clean ? tmd::Config::bgs_blob_buffer_size : 0;
+
+        // The static mask is already applied : the bgs only computes the
+        // pixels of m_region, the others are background. The cleanup may
+        // add foreground pixels at most buffer_size pixels away from it.
+        cv::Rect raw_box(0, 0, cols, rows);
+        cv::Rect box = raw_box;
+        if (!m_static_mask.empty()) {
+            raw_box = m_region.get_bounding_box();
+            box = clean ? get_cleanup_region().get_bounding_box() : raw_box;
+        }
+
+        // The rows of the bgs mask needed by the votes of the current row,
+        // in a ring.
+        const int ring_rows = 2 * buffer_size + 1;
+        if (m_votes.get_rows() != ring_rows || m_votes.get_cols() != cols) {
+            m_votes = tmd::PackedMask(ring_rows, cols);
+        }
+        int next_row = std::max(0, box.y - buffer_size);
+
+        const bool label = !tmd::Config::use_dpm_player_extractor;
+        const int radius = tmd::Config::blob_player_extractor_buffer_size / 2;
+        if (label) {
+            m_labeler.start(box, radius);
+        }
+
+        frame->packed_mask = tmd::PackedMask(rows, cols);
+        tmd::PackedMask &packed = frame->packed_mask;
+        const size_t row_size = packed.get_words_per_row() * sizeof(uint64_t);
+        for (int row = box.y; row < box.y + box.height; row++) {
+            const int last_row = std::min(rows - 1, row + buffer_size);
+            for (; next_row <= last_row; next_row++) {
+                if (raw_box.y <= next_row &&
+                    next_row < raw_box.y + raw_box.height) {
+                    m_votes.pack_row(next_row % ring_rows,
+                                     mask.ptr<uchar>(next_row), raw_box.x,
+                                     raw_box.x + raw_box.width);
+                }
+                else {
+                    m_votes.clear_row(next_row % ring_rows);
                 }
             }
+
+            uint64_t *words = packed.get_row(row);
+            memcpy(words, m_votes.get_row(row % ring_rows), row_size);
+            if (clean && row > 0) {
+                clean_row(row, packed);
+            }
+            if (label) {
+                m_labeler.add_row(words);
+            }
+        }
+
+        if (label) {
+            frame->mask_blobs = m_labeler.finish();
+            frame->mask_blobs_radius = radius;
         }
-        frame->mask_frame.release();
-        mask_copy.copyTo(frame->mask_frame);
-        mask_copy.release();
-        checked_pixels.release();
-        cv::Mat coloredMask = get_colored_mask_for_frame(frame);
-        frame->colored_mask_frame = coloredMask;
-        step();
-        return frame;
     }
 
-    int BGSubstractor::count_neighbours_in_fg(cv::Mat frame, int x, int y, int buffer_size) {
-        int count = 0;
-        for (int row = -buffer_size; row <= buffer_size; row++) {
-            for (int col = -buffer_size; col <= buffer_size; col++) {
-                if (x + col > 0 && x + col < frame.cols && y + row > 0 && y + row < frame.rows) {
-                    if (frame.at<uchar>(row + y, col + x) != 0) {
-                        count++;
+    void BGSubstractor::clean_row(int row, tmd::PackedMask &mask) {
+        const int buffer_size = tmd::Config::bgs_blob_buffer_size;
+        const int count_threshold = tmd::Config::bgs_blob_threshold_count;
+        const int ring_rows = m_votes.get_rows();
+        const int rows = mask.get_rows();
+        const int cols = mask.get_cols();
+        const int top = std::max(0, row - buffer_size);
+        const int bottom = std::min(rows - 1, row + buffer_size);
+
+        // The first column is left as it is. Every other pixel of the
+        // cleanup region having a foreground pixel at most buffer_size
+        // pixels away becomes foreground if more than count_threshold pixels
+        // around it (outside of the first row and column) are foreground,
+        // and background otherwise. The other pixels are already
+        // background.
+        // The pixels are counted a row of the window at a time, in the
+        // rows of the bgs mask.
+        for (const tmd::span_t &span : get_cleanup_region().get_spans(row)) {
+            for (int col = std::max(1, span.begin); col < span.end; col++) {
+                const int left = std::max(0, col - buffer_size);
+                const int right = std::min(cols, col + buffer_size + 1);
+
+                int around = 0;
+                int count = 0;
+                for (int window_row = top; window_row <= bottom;
+                     window_row++) {
+                    const int ring_row = window_row % ring_rows;
+                    const int pixels = m_votes.count(ring_row, left, right);
+                    around += pixels;
+                    if (window_row > 0) {
+                        count += left == 0 && m_votes.test(ring_row, 0) ?
+                                 pixels - 1 : pixels;
                     }
                 }
+                if (around == 0) {
+                    continue;
+                }
+                mask.set(row, col, count > count_threshold);
             }
         }
-        return count;
     }
 
     void BGSubstractor::set_threshold_value(float th) {
-        m_bgs->set("varThreshold", th);
+        m_bgs->set_threshold(th);
     }
 
     void BGSubstractor::set_history_size(int s) {
-        m_bgs->set("history", s);
+        m_bgs->set_history(s);
     }
 
     void BGSubstractor::set_learning_rate(float lr) {
         m_learning_rate = lr;
     }
 
+    bool BGSubstractor::catch_up(int frame_index) {
+        // Catch up from the last snapshot, or go through the warm-up frames
+        // before the given one, using the same step.
+        const bool fixed_updates = tmd::Config::bgs_update_interval > 0;
+        int restored_frame = restore_checkpoint(frame_index);
+        if (restored_frame >= 0) {
+            feed_model(restored_frame + (fixed_updates ? 1 : m_step_size),
+                       frame_index);
+            return true;
+        }
+        if (tmd::Config::bgs_warmup_frames > 0) {
+            int warmup_start = frame_index - (tmd::Config::
+                    bgs_warmup_frames / m_step_size) * m_step_size;
+            while (warmup_start <= 0) {
+                // The first frame is already in the model.
+                warmup_start += m_step_size;
+            }
+            feed_model(warmup_start, frame_index);
+            // Without fixed updates, the frames off the step are never
+            // given to the model anyway.
+            return warmup_start <= (fixed_updates ? 1 : m_step_size);
+        }
+        return frame_index == 0;
+    }
+
+    void BGSubstractor::catch_up(const std::string &video_folder,
+                                 int frame_index) {
+        if (m_source != NULL) {
+            throw std::invalid_argument("Error in BGSubstractor catch_up, "
+                                                "the BGSubstractor reads the "
+                                                "video itself.");
+        }
+        // The frames before frame_index are read from a source of our own.
+        m_source = tmd::FrameSource::open(video_folder, m_camera_index);
+        catch_up(frame_index);
+        delete m_source;
+        m_source = NULL;
+    }
+
+    int BGSubstractor::restore_checkpoint(int frame_index) {
+        const int interval = tmd::Config::bgs_checkpoint_interval;
+        if (interval <= 0 || frame_index <= 0) {
+            return -1;
+        }
+        // The snapshot of frame_index itself already contains this frame.
+        for (int index = ((frame_index - 1) / interval) * interval;
+             index >= 0; index -= interval) {
+            if (m_bgs->load(get_checkpoint_path(index), m_static_mask)) {
+                update_region();
+                tmd::debug("BGSubstractor", "restore_checkpoint", "Model of "
+                        "frame " + std::to_string(index) + " restored.");
+                return index;
+            }
+        }
+        return -1;
+    }
+
+    void BGSubstractor::feed_model(int from, int to) {
+        if (from >= to || !m_source->seek(from)) {
+            return;
+        }
+        tmd::debug("BGSubstractor", "feed_model", "Frames " +
+                   std::to_string(from) + " to " + std::to_string(to) +
+                   " given to the model.");
+        const bool fixed_updates = tmd::Config::bgs_update_interval > 0;
+        cv::Mat image, mask;
+        while (m_source->get_position() < to) {
+            const int position = m_source->get_position();
+            const bool update = fixed_updates ? is_update_frame(position) :
+                                (position - from) % m_step_size == 0;
+            if (!update) {
+                // Not decoded.
+                if (!m_source->skip()) {
+                    return;
+                }
+                continue;
+            }
+            if (!m_source->read(image)) {
+                return;
+            }
+            m_bgs->apply(reduce(image), mask, m_learning_rate);
+        }
+    }
+
+    bool BGSubstractor::is_update_frame(int frame_index) {
+        const int interval = tmd::Config::bgs_update_interval;
+        return interval <= 0 || frame_index % interval == 0;
+    }
+
+    std::string BGSubstractor::get_checkpoint_path(int frame_index) {
+        return tmd::Config::bgs_checkpoint_folder + "bgs_ace" +
+               std::to_string(m_camera_index) + "_" +
+               std::to_string(frame_index) + ".bin";
+    }
+
+    void BGSubstractor::save_checkpoint(int frame_index) {
+        if (!m_bgs->save(get_checkpoint_path(frame_index), m_static_mask)) {
+            tmd::debug("BGSubstractor", "save_checkpoint", "Couldn't save the"
+                    " model of frame " + std::to_string(frame_index));
+        }
+    }
+
     void BGSubstractor::jump_to_frame(int index) {
-        m_input_video.set(CV_CAP_PROP_POS_FRAMES, index);
+        if (m_source != NULL) {
+            m_source->seek(index);
+        }
         m_frame_index = index;
     }
 
@@ -172,9 +446,18 @@ namespace tmd {
     }
 
     void BGSubstractor::step(){
-        cv::Mat dummy;
-        for (int i = 0 ; i < m_step_size - 1 ; i ++){
-            m_input_video.read(dummy);
+        // The skipped frames are not decoded, unless they update the model.
+        const bool fixed_updates = tmd::Config::bgs_update_interval > 0;
+        cv::Mat image, mask;
+        for (int i = 0 ; i < m_images_per_step - 1 ; i ++){
+            if (fixed_updates && is_update_frame(m_frame_index + i + 1)) {
+                if (m_source->read(image)) {
+                    m_bgs->apply(reduce(image), mask, m_learning_rate);
+                }
+            }
+            else {
+                m_source->skip();
+            }
         }
         m_frame_index += m_step_size;
     }
@@ -0,0 +1,192 @@
+#include "../../headers/background_subtractor/checkpointable_mog2.h"
+#include <cstdio>
+#include <cstring>
+
+namespace {
+    const char SNAPSHOT_MAGIC[8] = {'T', 'M', 'D', 'M', 'O', 'G', '2', '1'};
+
+    // Layout of the mixtures in bgmodel, as in OpenCV : first the weight
+    // and variance of every mode of every pixel, then their means.
+    struct GMM {
+        float weight;
+        float variance;
+    };
+
+    template <typename T>
+    void write_value(std::ofstream &file, T value) {
+        file.write(reinterpret_cast<const char *>(&value), sizeof(T));
+    }
+
+    template <typename T>
+    bool read_value(std::ifstream &file, T &value) {
+        file.read(reinterpret_cast<char *>(&value), sizeof(T));
+        return file.good();
+    }
+}
+
+namespace tmd {
+    CheckpointableMOG2::CheckpointableMOG2(int history, float var_threshold,
+                                           bool shadow_detection)
+            : cv::BackgroundSubtractorMOG2(history, var_threshold,
+                                           shadow_detection) {
+    }
+
+    bool CheckpointableMOG2::is_initialized() {
+        return nframes > 0 && !bgmodel.empty();
+    }
+
+    bool CheckpointableMOG2::save(const std::string &path,
+                                  const cv::Mat &static_mask) {
+        if (!is_initialized()) {
+            return false;
+        }
+        const std::string tmp_path = path + ".tmp";
+        std::ofstream file(tmp_path, std::ios::binary);
+        if (!file.is_open()) {
+            return false;
+        }
+
+        const int channels = CV_MAT_CN(frameType);
+        const int pixel_count = frameSize.width * frameSize.height;
+
+        file.write(SNAPSHOT_MAGIC, sizeof(SNAPSHOT_MAGIC));
+        write_value<int>(file, frameSize.width);
+        write_value<int>(file, frameSize.height);
+        write_value<int>(file, frameType);
+        write_value<int>(file, nframes);
+        write_value<int>(file, history);
+        write_value<int>(file, nmixtures);
+        write_value<double>(file, varThreshold);
+        write_value<double>(file, backgroundRatio);
+        write_value<double>(file, varThresholdGen);
+        write_value<double>(file, fVarInit);
+        write_value<double>(file, fVarMin);
+        write_value<double>(file, fVarMax);
+        write_value<double>(file, fCT);
+        write_value<double>(file, fTau);
+        write_value<int>(file, bShadowDetection);
+        write_value<int>(file, nShadowDetection);
+
+        // Only the used modes of each pixel.
+        const unsigned char *used_modes = bgmodelUsedModes.ptr<uchar>();
+        const GMM *gmm = reinterpret_cast<const GMM *>(bgmodel.ptr<float>());
+        const float *mean = reinterpret_cast<const float *>(
+                gmm + pixel_count * nmixtures);
+        file.write(reinterpret_cast<const char *>(used_modes), pixel_count);
+        for (int p = 0; p < pixel_count; p++) {
+            const int modes = used_modes[p];
+            file.write(reinterpret_cast<const char *>(gmm + p * nmixtures),
+                       modes * sizeof(GMM));
+            file.write(reinterpret_cast<const char *>(
+                               mean + p * nmixtures * channels),
+                       modes * channels * sizeof(float));
+        }
+
+        cv::Mat mask = static_mask.isContinuous() ? static_mask :
+                       static_mask.clone();
+        write_value<int>(file, mask.rows);
+        write_value<int>(file, mask.cols);
+        write_value<int>(file, mask.type());
+        file.write(reinterpret_cast<const char *>(mask.data),
+                   mask.total() * mask.elemSize());
+
+        file.close();
+        if (file.fail()) {
+            std::remove(tmp_path.c_str());
+            return false;
+        }
+        return std::rename(tmp_path.c_str(), path.c_str()) == 0;
+    }
+
+    bool CheckpointableMOG2::load(const std::string &path,
+                                  cv::Mat &static_mask) {
+        std::ifstream file(path, std::ios::binary);
+        if (!file.is_open()) {
+            return false;
+        }
+
+        char magic[sizeof(SNAPSHOT_MAGIC)];
+        file.read(magic, sizeof(magic));
+        if (!file.good() || memcmp(magic, SNAPSHOT_MAGIC, sizeof(magic))) {
+            return false;
+        }
+
+        int width, height, type, frames, history_size, mixtures;
+        double var_threshold, background_ratio, var_threshold_gen, var_init,
+                var_min, var_max, ct, tau;
+        int shadow_detection, shadow_value;
+        if (!read_value(file, width) || !read_value(file, height) ||
+            !read_value(file, type) || !read_value(file, frames) ||
+            !read_value(file, history_size) || !read_value(file, mixtures) ||
+            !read_value(file, var_threshold) ||
+            !read_value(file, background_ratio) ||
+            !read_value(file, var_threshold_gen) ||
+            !read_value(file, var_init) || !read_value(file, var_min) ||
+            !read_value(file, var_max) || !read_value(file, ct) ||
+            !read_value(file, tau) || !read_value(file, shadow_detection) ||
+            !read_value(file, shadow_value)) {
+            return false;
+        }
+        if (width <= 0 || height <= 0 || mixtures <= 0) {
+            return false;
+        }
+
+        const int channels = CV_MAT_CN(type);
+        const int pixel_count = width * height;
+
+        // Everything is read before the model is touched.
+        cv::Mat new_used_modes(height, width, CV_8U);
+        cv::Mat new_model = cv::Mat::zeros(
+                1, pixel_count * mixtures * (2 + channels), CV_32F);
+        unsigned char *used_modes = new_used_modes.ptr<uchar>();
+        GMM *gmm = reinterpret_cast<GMM *>(new_model.ptr<float>());
+        float *mean = reinterpret_cast<float *>(gmm + pixel_count * mixtures);
+
+        file.read(reinterpret_cast<char *>(used_modes), pixel_count);
+        for (int p = 0; p < pixel_count && file.good(); p++) {
+            const int modes = used_modes[p];
+            if (modes > mixtures) {
+                return false;
+            }
+            file.read(reinterpret_cast<char *>(gmm + p * mixtures),
+                      modes * sizeof(GMM));
+            file.read(reinterpret_cast<char *>(mean + p * mixtures * channels),
+                      modes * channels * sizeof(float));
+        }
+
+        int mask_rows, mask_cols, mask_type;
+        if (!read_value(file, mask_rows) || !read_value(file, mask_cols) ||
+            !read_value(file, mask_type)) {
+            return false;
+        }
+        cv::Mat new_mask;
+        if (mask_rows > 0 && mask_cols > 0) {
+            new_mask.create(mask_rows, mask_cols, mask_type);
+            file.read(reinterpret_cast<char *>(new_mask.data),
+                      new_mask.total() * new_mask.elemSize());
+        }
+        if (file.fail()) {
+            return false;
+        }
+
+        frameSize = cv::Size(width, height);
+        frameType = type;
+        nframes = frames;
+        history = history_size;
+        nmixtures = mixtures;
+        varThreshold = var_threshold;
+        backgroundRatio = background_ratio;
+        varThresholdGen = var_threshold_gen;
+        fVarInit = var_init;
+        fVarMin = var_min;
+        fVarMax = var_max;
+        fCT = ct;
+        fTau = tau;
+        bShadowDetection = shadow_detection != 0;
+        nShadowDetection = (unsigned char) shadow_value;
+        bgmodel = new_model;
+        bgmodelUsedModes = new_used_modes;
+        static_mask = new_mask;
+        return true;
+    }
+}
@@ -0,0 +1,117 @@
+#include "../../headers/background_subtractor/mask_region.h"
+#include <algorithm>
+
+namespace tmd {
+    MaskRegion::MaskRegion() {
+        m_bounding_box = cv::Rect(0, 0, 0, 0);
+        m_size = cv::Size(0, 0);
+    }
+
+    MaskRegion::MaskRegion(const cv::Mat &mask) {
+        m_size = mask.size();
+        m_spans.resize(mask.rows);
+
+        int min_row = mask.rows, min_col = mask.cols, max_row = -1,
+                max_col = -1;
+        for (int row = 0; row < mask.rows; row++) {
+            const uchar *pixels = mask.ptr<uchar>(row);
+            int col = 0;
+            while (col < mask.cols) {
+                if (pixels[col] == 0) {
+                    col++;
+                    continue;
+                }
+                span_t span;
+                span.begin = col;
+                while (col < mask.cols && pixels[col] != 0) {
+                    col++;
+                }
+                span.end = col;
+                m_spans[row].push_back(span);
+
+                min_row = std::min(min_row, row);
+                max_row = row;
+                min_col = std::min(min_col, span.begin);
+                max_col = std::max(max_col, span.end - 1);
+            }
+        }
+
+        if (max_row < 0) {
+            m_bounding_box = cv::Rect(0, 0, 0, 0);
+        }
+        else {
+            m_bounding_box = cv::Rect(min_col, min_row, max_col - min_col + 1,
+                                      max_row - min_row + 1);
+        }
+    }
+
+    MaskRegion MaskRegion::dilate(int radius) const {
+        MaskRegion result;
+        result.m_size = m_size;
+        result.m_spans.resize(m_spans.size());
+        if (m_bounding_box.area() == 0 || radius <= 0) {
+            result.m_spans = m_spans;
+            result.m_bounding_box = m_bounding_box;
+            return result;
+        }
+
+        const int rows = m_size.height;
+        const int cols = m_size.width;
+        for (int row = 0; row < rows; row++) {
+            // The spans of the rows around, widened and merged.
+            std::vector<span_t> spans;
+            for (int other = std::max(0, row - radius);
+                 other <= std::min(rows - 1, row + radius); other++) {
+                for (const span_t &span : m_spans[other]) {
+                    span_t widened;
+                    widened.begin = std::max(0, span.begin - radius);
+                    widened.end = std::min(cols, span.end + radius);
+                    spans.push_back(widened);
+                }
+            }
+            std::sort(spans.begin(), spans.end(),
+                      [](const span_t &a, const span_t &b) {
+                          return a.begin < b.begin;
+                      });
+            for (const span_t &span : spans) {
+                std::vector<span_t> &merged = result.m_spans[row];
+                if (!merged.empty() && span.begin <= merged.back().end) {
+                    merged.back().end = std::max(merged.back().end, span.end);
+                }
+                else {
+                    merged.push_back(span);
+                }
+            }
+        }
+
+        cv::Rect box = m_bounding_box;
+        box.x -= radius;
+        box.y -= radius;
+        box.width += 2 * radius;
+        box.height += 2 * radius;
+        result.m_bounding_box = box & cv::Rect(0, 0, cols, rows);
+        return result;
+    }
+
+    const std::vector<span_t> &MaskRegion::get_spans(int row) const {
+        return m_spans[row];
+    }
+
+    cv::Rect MaskRegion::get_bounding_box() const {
+        return m_bounding_box;
+    }
+
+    cv::Size MaskRegion::get_size() const {
+        return m_size;
+    }
+
+    long MaskRegion::get_area() const {
+        long area = 0;
+        for (const std::vector<span_t> &spans : m_spans) {
+            for (const span_t &span : spans) {
+                area += span.end - span.begin;
+            }
+        }
+        return area;
+    }
+}
@@ -0,0 +1,167 @@
+#include "../../headers/background_subtractor/packed_mask.h"
+#include "../../headers/misc/debug.h"
+#include <algorithm>
+#include <cstring>
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <immintrin.h>
+#define TMD_PACKED_MASK_X86
+#endif
+
+namespace {
+    /**
+     * Kernels setting the bits of the non zero bytes of "pixels" in
+     * "words", the first one being column "begin" of the row, up to "end".
+     * The bits are only set, never cleared.
+     */
+    typedef void (*pack_kernel_t)(const uchar *pixels, int begin, int end,
+                                  uint64_t *words);
+
+    void pack_scalar(const uchar *pixels, int begin, int end,
+                     uint64_t *words) {
+        for (int col = begin; col < end; col++) {
+            if (pixels[col] != 0) {
+                words[col >> 6] |= uint64_t(1) << (col & 63);
+            }
+        }
+    }
+
+#ifdef TMD_PACKED_MASK_X86
+    __attribute__((target("sse2")))
+    void pack_sse2(const uchar *pixels, int begin, int end,
+                   uint64_t *words) {
+        const __m128i zero = _mm_setzero_si128();
+        int col = begin;
+        for (; col + 16 <= end; col += 16) {
+            const __m128i bytes = _mm_loadu_si128(reinterpret_cast<
+                    const __m128i *>(pixels + col));
+            const uint64_t bits = static_cast<uint64_t>(
+                    ~_mm_movemask_epi8(_mm_cmpeq_epi8(bytes, zero)) & 0xFFFF);
+            if (bits == 0) {
+                continue;
+            }
+            const int shift = col & 63;
+            words[col >> 6] |= bits << shift;
+            if (shift > 48) {
+                // The 16 bits go over two words.
+                words[(col >> 6) + 1] |= bits >> (64 - shift);
+            }
+        }
+        pack_scalar(pixels, col, end, words);
+    }
+#endif
+
+    /**
+     * Returns the best kernel supported by the processor.
+     */
+    pack_kernel_t select_pack_kernel() {
+#ifdef TMD_PACKED_MASK_X86
+        __builtin_cpu_init();
+        if (__builtin_cpu_supports("sse2")) {
+            tmd::debug("PackedMask", "select_pack_kernel", "SSE2");
+            return pack_sse2;
+        }
+#endif
+        tmd::debug("PackedMask", "select_pack_kernel", "scalar");
+        return pack_scalar;
+    }
+}
+
+namespace tmd {
+    PackedMask::PackedMask() {
+        m_rows = 0;
+        m_cols = 0;
+        m_words_per_row = 0;
+    }
+
+    PackedMask::PackedMask(int rows, int cols) {
+        m_rows = rows;
+        m_cols = cols;
+        m_words_per_row = (cols + 63) / 64;
+        m_words.assign(static_cast<size_t>(rows) * m_words_per_row, 0);
+    }
+
+    PackedMask::PackedMask(const cv::Mat &mask, const cv::Rect &roi)
+            : PackedMask(mask.rows, mask.cols) {
+        const cv::Rect full(0, 0, mask.cols, mask.rows);
+        const cv::Rect box = roi.area() > 0 ? roi & full : full;
+        for (int row = box.y; row < box.y + box.height; row++) {
+            pack_row(row, mask.ptr<uchar>(row), box.x, box.x + box.width);
+        }
+    }
+
+    void PackedMask::pack_row(int row, const uchar *pixels, int begin,
+                              int end) {
+        static const pack_kernel_t pack_kernel = select_pack_kernel();
+
+        clear_row(row);
+        pack_kernel(pixels, begin, end, get_row(row));
+    }
+
+    void PackedMask::clear_row(int row) {
+        memset(get_row(row), 0, m_words_per_row * sizeof(uint64_t));
+    }
+
+    bool PackedMask::empty() const {
+        return m_words.empty();
+    }
+
+    int PackedMask::get_rows() const {
+        return m_rows;
+    }
+
+    int PackedMask::get_cols() const {
+        return m_cols;
+    }
+
+    int PackedMask::count(int row, int begin, int end) const {
+        if (begin >= end) {
+            return 0;
+        }
+        const uint64_t *words = &m_words[row * m_words_per_row];
+        const int first = begin >> 6;
+        const int last = (end - 1) >> 6;
+        const uint64_t first_bits = ~uint64_t(0) << (begin & 63);
+        const uint64_t last_bits = ~uint64_t(0) >> (63 - ((end - 1) & 63));
+        if (first == last) {
+            return __builtin_popcountll(words[first] & first_bits & last_bits);
+        }
+        int total = __builtin_popcountll(words[first] & first_bits);
+        for (int word = first + 1; word < last; word++) {
+            total += __builtin_popcountll(words[word]);
+        }
+        return total + __builtin_popcountll(words[last] & last_bits);
+    }
+
+    const uint64_t *PackedMask::get_row(int row) const {
+        return &m_words[row * m_words_per_row];
+    }
+
+    uint64_t *PackedMask::get_row(int row) {
+        return &m_words[row * m_words_per_row];
+    }
+
+    int PackedMask::get_words_per_row() const {
+        return m_words_per_row;
+    }
+
+    void PackedMask::unpack(cv::Mat &mask) const {
+        mask.create(m_rows, m_cols, CV_8U);
+        for (int row = 0; row < m_rows; row++) {
+            const uint64_t *words = get_row(row);
+            uchar *pixels = mask.ptr<uchar>(row);
+            for (int word = 0; word < m_words_per_row; word++) {
+                const int begin = word * 64;
+                const int end = std::min(m_cols, begin + 64);
+                if (words[word] == 0) {
+                    memset(pixels + begin, 0, end - begin);
+                    continue;
+                }
+                for (int col = begin; col < end; col++) {
+                    pixels[col] = static_cast<uchar>(
+                            (words[word] >> (col - begin)) & 1 ? 255 : 0);
+                }
+            }
+        }
+    }
+}
@@ -0,0 +1,551 @@
+#include "../../headers/background_subtractor/parallel_mog2.h"
+#include "../../headers/misc/thread_pool.h"
+#include <algorithm>
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <immintrin.h>
+#define TMD_MOG2_X86
+#endif
+
+namespace {
+    // bgmodel holds the weight and the variance of every mode of every
+    // pixel, followed by the means, as in OpenCV.
+    const int GMM_SIZE = 2;
+
+    /**
+     * Kernels testing "count" pixels against their first mode. The pixels
+     * and the first modes are given as planes (one per channel).
+     * A pixel fitting its first mode is decided : its value is written in
+     * "mask" and "decided" is set to 1. Without shadow detection, a pixel
+     * fitting its first mode is always decided, with it only the ones
+     * fitting as background are.
+     */
+    typedef void (*first_mode_kernel_t)(const float *const *data,
+                                        const float *const *mean,
+                                        const float *variance,
+                                        float var_threshold,
+                                        float var_threshold_gen,
+                                        bool shadows, uchar *mask,
+                                        uchar *decided, int count);
+
+    void first_mode_scalar(const float *const *data, const float *const *mean,
+                           const float *variance, float var_threshold,
+                           float var_threshold_gen, bool shadows, uchar *mask,
+                           uchar *decided, int count) {
+        for (int x = 0; x < count; x++) {
+            const float d0 = mean[0][x] - data[0][x];
+            const float d1 = mean[1][x] - data[1][x];
+            const float d2 = mean[2][x] - data[2][x];
+            const float dist2 = d0 * d0 + d1 * d1 + d2 * d2;
+            const bool fits = dist2 < var_threshold_gen * variance[x];
+            const bool background = dist2 < var_threshold * variance[x];
+            mask[x] = static_cast<uchar>(background ? 0 : 255);
+            decided[x] = static_cast<uchar>(fits && (background || !shadows));
+        }
+    }
+
+#ifdef TMD_MOG2_X86
+    __attribute__((target("sse2")))
+    void first_mode_sse2(const float *const *data, const float *const *mean,
+                         const float *variance, float var_threshold,
+                         float var_threshold_gen, bool shadows, uchar *mask,
+                         uchar *decided, int count) {
+        const __m128 tb = _mm_set1_ps(var_threshold);
+        const __m128 tg = _mm_set1_ps(var_threshold_gen);
+        int x = 0;
+        for (; x + 4 <= count; x += 4) {
+            const __m128 d0 = _mm_sub_ps(_mm_loadu_ps(mean[0] + x),
+                                         _mm_loadu_ps(data[0] + x));
+            const __m128 d1 = _mm_sub_ps(_mm_loadu_ps(mean[1] + x),
+                                         _mm_loadu_ps(data[1] + x));
+            const __m128 d2 = _mm_sub_ps(_mm_loadu_ps(mean[2] + x),
+                                         _mm_loadu_ps(data[2] + x));
+            const __m128 dist2 = _mm_add_ps(_mm_add_ps(_mm_mul_ps(d0, d0),
+                                                       _mm_mul_ps(d1, d1)),
+                                            _mm_mul_ps(d2, d2));
+            const __m128 var = _mm_loadu_ps(variance + x);
+            const int fits = _mm_movemask_ps(
+                    _mm_cmplt_ps(dist2, _mm_mul_ps(tg, var)));
+            const int background = _mm_movemask_ps(
+                    _mm_cmplt_ps(dist2, _mm_mul_ps(tb, var)));
+            const int done = shadows ? fits & background : fits;
+            for (int i = 0; i < 4; i++) {
+                mask[x + i] = static_cast<uchar>(
+                        (background >> i) & 1 ? 0 : 255);
+                decided[x + i] = static_cast<uchar>((done >> i) & 1);
+            }
+        }
+        const float *const data_tail[3] = {data[0] + x, data[1] + x,
+                                           data[2] + x};
+        const float *const mean_tail[3] = {mean[0] + x, mean[1] + x,
+                                           mean[2] + x};
+        first_mode_scalar(data_tail, mean_tail, variance + x, var_threshold,
+                          var_threshold_gen, shadows, mask + x, decided + x,
+                          count - x);
+    }
+
+    __attribute__((target("avx2")))
+    void first_mode_avx2(const float *const *data, const float *const *mean,
+                         const float *variance, float var_threshold,
+                         float var_threshold_gen, bool shadows, uchar *mask,
+                         uchar *decided, int count) {
+        const __m256 tb = _mm256_set1_ps(var_threshold);
+        const __m256 tg = _mm256_set1_ps(var_threshold_gen);
+        int x = 0;
+        for (; x + 8 <= count; x += 8) {
+            const __m256 d0 = _mm256_sub_ps(_mm256_loadu_ps(mean[0] + x),
+                                            _mm256_loadu_ps(data[0] + x));
+            const __m256 d1 = _mm256_sub_ps(_mm256_loadu_ps(mean[1] + x),
+                                            _mm256_loadu_ps(data[1] + x));
+            const __m256 d2 = _mm256_sub_ps(_mm256_loadu_ps(mean[2] + x),
+                                            _mm256_loadu_ps(data[2] + x));
+            // Multiplications and additions are kept separate (no FMA) to
+            // round exactly as the scalar code.
+            const __m256 dist2 = _mm256_add_ps(
+                    _mm256_add_ps(_mm256_mul_ps(d0, d0),
+                                  _mm256_mul_ps(d1, d1)),
+                    _mm256_mul_ps(d2, d2));
+            const __m256 var = _mm256_loadu_ps(variance + x);
+            const int fits = _mm256_movemask_ps(_mm256_cmp_ps(
+                    dist2, _mm256_mul_ps(tg, var), _CMP_LT_OQ));
+            const int background = _mm256_movemask_ps(_mm256_cmp_ps(
+                    dist2, _mm256_mul_ps(tb, var), _CMP_LT_OQ));
+            const int done = shadows ? fits & background : fits;
+            for (int i = 0; i < 8; i++) {
+                mask[x + i] = static_cast<uchar>(
+                        (background >> i) & 1 ? 0 : 255);
+                decided[x + i] = static_cast<uchar>((done >> i) & 1);
+            }
+        }
+        const float *const data_tail[3] = {data[0] + x, data[1] + x,
+                                           data[2] + x};
+        const float *const mean_tail[3] = {mean[0] + x, mean[1] + x,
+                                           mean[2] + x};
+        first_mode_scalar(data_tail, mean_tail, variance + x, var_threshold,
+                          var_threshold_gen, shadows, mask + x, decided + x,
+                          count - x);
+    }
+#endif
+
+    /**
+     * Returns the best kernel supported by the processor.
+     */
+    first_mode_kernel_t select_first_mode_kernel() {
+#ifdef TMD_MOG2_X86
+        __builtin_cpu_init();
+        if (__builtin_cpu_supports("avx2")) {
+            tmd::debug("ParallelMOG2", "select_first_mode_kernel", "AVX2");
+            return first_mode_avx2;
+        }
+        if (__builtin_cpu_supports("sse2")) {
+            tmd::debug("ParallelMOG2", "select_first_mode_kernel", "SSE2");
+            return first_mode_sse2;
+        }
+#endif
+        tmd::debug("ParallelMOG2", "select_first_mode_kernel", "scalar");
+        return first_mode_scalar;
+    }
+
+    void swap_modes(float *gmm, float *mean, int channels, int a, int b) {
+        std::swap(gmm[a * GMM_SIZE], gmm[b * GMM_SIZE]);
+        std::swap(gmm[a * GMM_SIZE + 1], gmm[b * GMM_SIZE + 1]);
+        for (int c = 0; c < channels; c++) {
+            std::swap(mean[a * channels + c], mean[b * channels + c]);
+        }
+    }
+}
+
+namespace tmd {
+    ParallelMOG2::ParallelMOG2(int history, float var_threshold,
+                               bool shadow_detection)
+            : CheckpointableMOG2(history, var_threshold, shadow_detection) {
+        m_first_modes_valid = false;
+        m_region = NULL;
+    }
+
+    void ParallelMOG2::operator()(cv::InputArray _image,
+                                  cv::OutputArray _fgmask,
+                                  double learningRate) {
+        cv::Mat image = _image.getMat();
+        const bool need_to_initialize = nframes == 0 || learningRate >= 1 ||
+                                        image.size() != frameSize ||
+                                        image.type() != frameType;
+        if (need_to_initialize) {
+            initialize(image.size(), image.type());
+            m_first_modes_valid = false;
+        }
+
+        _fgmask.create(image.size(), CV_8U);
+        cv::Mat mask = _fgmask.getMat();
+
+        ++nframes;
+        learningRate = learningRate >= 0 && nframes > 1 ? learningRate :
+                       1. / std::min(2 * nframes, history);
+
+        // The model only changes with a positive learning rate.
+        const bool frozen = learningRate == 0;
+        if (!frozen) {
+            m_first_modes_valid = false;
+        }
+        else if (!m_first_modes_valid && image.channels() == 3) {
+            build_first_modes();
+        }
+
+        // Outside of the region, the pixels are background.
+        cv::Rect box(0, 0, image.cols, image.rows);
+        m_full_row.assign(1, span_t{0, image.cols});
+        if (m_region != NULL) {
+            box = m_region->get_bounding_box();
+            mask.setTo(cv::Scalar::all(0));
+        }
+
+        tmd::ThreadPool *pool = tmd::ThreadPool::get_instance();
+        const int band_count = std::max(1, std::min(box.height,
+                                                    pool->get_thread_count()));
+        std::vector<tmd::ThreadPool::task_t> tasks;
+        for (int band = 0; band < band_count; band++) {
+            const int row_begin = box.y + box.height * band / band_count;
+            const int row_end = box.y + box.height * (band + 1) / band_count;
+            const float learning_rate = static_cast<float>(learningRate);
+            tasks.push_back([this, &image, &mask, row_begin, row_end, box,
+                                    frozen, learning_rate]{
+                cv::Rect band_box(box.x, row_begin, box.width,
+                                  row_end - row_begin);
+                if (frozen) {
+                    classify_rows(image, mask, band_box);
+                }
+                else {
+                    update_rows(image, mask, band_box, learning_rate);
+                }
+            });
+        }
+        pool->run_all(tasks);
+    }
+
+    void ParallelMOG2::apply(const cv::Mat &image, cv::Mat &mask,
+                             double learning_rate) {
+        operator()(image, mask, learning_rate);
+    }
+
+    void ParallelMOG2::set_region(const tmd::MaskRegion *region) {
+        m_region = region;
+    }
+
+    void ParallelMOG2::set_threshold(float threshold) {
+        set("varThreshold", threshold);
+    }
+
+    void ParallelMOG2::set_history(int history) {
+        set("history", history);
+    }
+
+    bool ParallelMOG2::save(const std::string &path,
+                            const cv::Mat &static_mask) {
+        return CheckpointableMOG2::save(path, static_mask);
+    }
+
+    bool ParallelMOG2::load(const std::string &path, cv::Mat &static_mask) {
+        if (!CheckpointableMOG2::load(path, static_mask)) {
+            return false;
+        }
+        m_first_modes_valid = false;
+        return true;
+    }
+
+    const std::vector<tmd::span_t> &ParallelMOG2::get_spans(int row) {
+        return m_region != NULL ? m_region->get_spans(row) : m_full_row;
+    }
+
+    void ParallelMOG2::update_rows(const cv::Mat &image, cv::Mat &mask,
+                                   const cv::Rect &box, float learning_rate) {
+        const int channels = image.channels();
+        cv::Mat row_data;
+        for (int y = box.y; y < box.y + box.height; y++) {
+            image.row(y).colRange(box.x, box.x + box.width).convertTo(
+                    row_data, CV_32F);
+            const float *data = row_data.ptr<float>();
+            uchar *mask_row = mask.ptr<uchar>(y);
+            for (const tmd::span_t &span : get_spans(y)) {
+                for (int x = span.begin; x < span.end; x++) {
+                    mask_row[x] = update_pixel(data + (x - box.x) * channels,
+                                               channels, y * image.cols + x,
+                                               learning_rate);
+                }
+            }
+        }
+    }
+
+    uchar ParallelMOG2::update_pixel(const float *data, int channels,
+                                     int pixel, float learning_rate) {
+        const int pixel_count = frameSize.width * frameSize.height;
+        float *gmm = bgmodel.ptr<float>() + pixel * nmixtures * GMM_SIZE;
+        float *mean = bgmodel.ptr<float>() +
+                      pixel_count * nmixtures * GMM_SIZE +
+                      pixel * nmixtures * channels;
+        uchar *modes_used = bgmodelUsedModes.ptr<uchar>();
+
+        const float alpha = learning_rate;
+        const float alpha1 = 1.f - alpha;
+        const float prune = -learning_rate * fCT;
+        const float var_threshold = static_cast<float>(varThreshold);
+        float diff[4];
+
+        bool background = false;
+        bool fits = false; // A new mode is added if none fits.
+        int modes = modes_used[pixel];
+        float total_weight = 0.f;
+
+        // The modes are sorted by decreasing weight.
+        float *mean_mode = mean;
+        for (int mode = 0; mode < modes; mode++, mean_mode += channels) {
+            float weight = alpha1 * gmm[mode * GMM_SIZE] + prune;
+            int swap_count = 0;
+
+            if (!fits) {
+                const float var = gmm[mode * GMM_SIZE + 1];
+                float dist2 = 0.f;
+                for (int c = 0; c < channels; c++) {
+                    diff[c] = mean_mode[c] - data[c];
+                    dist2 += diff[c] * diff[c];
+                }
+
+                if (total_weight < backgroundRatio &&
+                    dist2 < var_threshold * var) {
+                    background = true;
+                }
+
+                if (dist2 < varThresholdGen * var) {
+                    fits = true;
+
+                    weight += alpha;
+                    const float k = alpha / weight;
+                    for (int c = 0; c < channels; c++) {
+                        mean_mode[c] -= k * diff[c];
+                    }
+                    float new_var = var + k * (dist2 - var);
+                    new_var = std::max(new_var, fVarMin);
+                    new_var = std::min(new_var, fVarMax);
+                    gmm[mode * GMM_SIZE + 1] = new_var;
+
+                    // Only this weight went up, move it up.
+                    for (int i = mode; i > 0; i--) {
+                        if (weight < gmm[(i - 1) * GMM_SIZE]) {
+                            break;
+                        }
+                        swap_count++;
+                        swap_modes(gmm, mean, channels, i, i - 1);
+                    }
+                }
+            }
+
+            if (weight < -prune) {
+                weight = 0.f;
+                modes--;
+            }
+            gmm[(mode - swap_count) * GMM_SIZE] = weight;
+            total_weight += weight;
+        }
+
+        const float inverse_weight = total_weight > 0.f ?
+                                     1.f / total_weight : 0.f;
+        for (int mode = 0; mode < modes; mode++) {
+            gmm[mode * GMM_SIZE] *= inverse_weight;
+        }
+
+        if (!fits && alpha > 0.f) {
+            // Replace the weakest mode, or add a new one.
+            const int mode = modes == nmixtures ? nmixtures - 1 : modes++;
+            if (modes == 1) {
+                gmm[mode * GMM_SIZE] = 1.f;
+            }
+            else {
+                gmm[mode * GMM_SIZE] = alpha;
+                for (int i = 0; i < modes - 1; i++) {
+                    gmm[i * GMM_SIZE] *= alpha1;
+                }
+            }
+            for (int c = 0; c < channels; c++) {
+                mean[mode * channels + c] = data[c];
+            }
+            gmm[mode * GMM_SIZE + 1] = fVarInit;
+
+            for (int i = modes - 1; i > 0; i--) {
+                if (alpha < gmm[(i - 1) * GMM_SIZE]) {
+                    break;
+                }
+                swap_modes(gmm, mean, channels, i, i - 1);
+            }
+        }
+
+        modes_used[pixel] = static_cast<uchar>(modes);
+        if (background) {
+            return 0;
+        }
+        if (bShadowDetection && is_shadow(data, channels, modes, gmm, mean)) {
+            return nShadowDetection;
+        }
+        return 255;
+    }
+
+    void ParallelMOG2::classify_rows(const cv::Mat &image, cv::Mat &mask,
+                                     const cv::Rect &box) {
+        static const first_mode_kernel_t first_mode_kernel =
+                select_first_mode_kernel();
+
+        const int cols = image.cols;
+        const int channels = image.channels();
+        const bool use_first_modes = m_first_modes_valid &&
+                                     backgroundRatio > 0 &&
+                                     varThreshold > 0 && varThresholdGen > 0;
+
+        cv::Mat row_data;
+        std::vector<float> planes(3 * box.width);
+        std::vector<uchar> decided(cols, 0);
+
+        for (int y = box.y; y < box.y + box.height; y++) {
+            image.row(y).colRange(box.x, box.x + box.width).convertTo(
+                    row_data, CV_32F);
+            const float *data = row_data.ptr<float>();
+            uchar *mask_row = mask.ptr<uchar>(y);
+
+            if (use_first_modes) {
+                for (int x = 0; x < box.width; x++) {
+                    planes[x] = data[3 * x];
+                    planes[box.width + x] = data[3 * x + 1];
+                    planes[2 * box.width + x] = data[3 * x + 2];
+                }
+            }
+
+            for (const tmd::span_t &span : get_spans(y)) {
+                if (use_first_modes) {
+                    const int offset = span.begin - box.x;
+                    const int pixel = y * cols + span.begin;
+                    const float *const data_planes[3] = {
+                            &planes[offset], &planes[box.width + offset],
+                            &planes[2 * box.width + offset]};
+                    const float *const mean_planes[3] = {
+                            &m_first_mean[0][pixel], &m_first_mean[1][pixel],
+                            &m_first_mean[2][pixel]};
+                    first_mode_kernel(data_planes, mean_planes,
+                                      &m_first_variance[pixel],
+                                      static_cast<float>(varThreshold),
+                                      varThresholdGen, bShadowDetection != 0,
+                                      mask_row + span.begin,
+                                      &decided[span.begin],
+                                      span.end - span.begin);
+                }
+                for (int x = span.begin; x < span.end; x++) {
+                    if (!decided[x]) {
+                        mask_row[x] = classify_pixel(
+                                data + (x - box.x) * channels, channels,
+                                y * cols + x);
+                    }
+                }
+            }
+        }
+    }
+
+    uchar ParallelMOG2::classify_pixel(const float *data, int channels,
+                                       int pixel) {
+        const int pixel_count = frameSize.width * frameSize.height;
+        const float *gmm = bgmodel.ptr<float>() +
+                           pixel * nmixtures * GMM_SIZE;
+        const float *mean = bgmodel.ptr<float>() +
+                            pixel_count * nmixtures * GMM_SIZE +
+                            pixel * nmixtures * channels;
+        const int modes = bgmodelUsedModes.ptr<uchar>()[pixel];
+        const float var_threshold = static_cast<float>(varThreshold);
+
+        // Same tests as update_rows(), on a model which doesn't change.
+        bool background = false;
+        float total_weight = 0.f;
+        for (int mode = 0; mode < modes; mode++) {
+            const float var = gmm[mode * GMM_SIZE + 1];
+            const float *mean_mode = mean + mode * channels;
+            float dist2 = 0.f;
+            for (int c = 0; c < channels; c++) {
+                const float diff = mean_mode[c] - data[c];
+                dist2 += diff * diff;
+            }
+            if (total_weight < backgroundRatio &&
+                dist2 < var_threshold * var) {
+                background = true;
+            }
+            if (dist2 < varThresholdGen * var) {
+                break;
+            }
+            total_weight += gmm[mode * GMM_SIZE];
+        }
+
+        if (background) {
+            return 0;
+        }
+        if (bShadowDetection && is_shadow(data, channels, modes, gmm, mean)) {
+            return nShadowDetection;
+        }
+        return 255;
+    }
+
+    bool ParallelMOG2::is_shadow(const float *data, int channels, int modes,
+                                 const float *gmm, const float *mean) {
+        const float var_threshold = static_cast<float>(varThreshold);
+        float total_weight = 0.f;
+
+        // Only the background modes are checked.
+        for (int mode = 0; mode < modes; mode++, mean += channels) {
+            float numerator = 0.f;
+            float denominator = 0.f;
+            for (int c = 0; c < channels; c++) {
+                numerator += data[c] * mean[c];
+                denominator += mean[c] * mean[c];
+            }
+            if (denominator == 0) {
+                return false;
+            }
+
+            // The pixel is a darker version of the mode.
+            if (numerator <= denominator && numerator >= fTau * denominator) {
+                const float a = numerator / denominator;
+                float dist2a = 0.f;
+                for (int c = 0; c < channels; c++) {
+                    const float diff = a * mean[c] - data[c];
+                    dist2a += diff * diff;
+                }
+                if (dist2a < var_threshold * gmm[mode * GMM_SIZE + 1] * a * a) {
+                    return true;
+                }
+            }
+
+            total_weight += gmm[mode * GMM_SIZE];
+            if (total_weight > backgroundRatio) {
+                return false;
+            }
+        }
+        return false;
+    }
+
+    void ParallelMOG2::build_first_modes() {
+        const int pixel_count = frameSize.width * frameSize.height;
+        const float *gmm = bgmodel.ptr<float>();
+        const float *mean = gmm + pixel_count * nmixtures * GMM_SIZE;
+        const uchar *modes_used = bgmodelUsedModes.ptr<uchar>();
+
+        for (int c = 0; c < 3; c++) {
+            m_first_mean[c].assign(pixel_count, 0.f);
+        }
+        m_first_variance.assign(pixel_count, -1.f);
+
+        for (int pixel = 0; pixel < pixel_count; pixel++) {
+            // A negative variance never fits, the pixel goes through
+            // classify_pixel().
+            if (modes_used[pixel] == 0) {
+                continue;
+            }
+            for (int c = 0; c < 3; c++) {
+                m_first_mean[c][pixel] = mean[pixel * nmixtures * 3 + c];
+            }
+            m_first_variance[pixel] = gmm[pixel * nmixtures * GMM_SIZE + 1];
+        }
+        m_first_modes_valid = true;
+    }
+}
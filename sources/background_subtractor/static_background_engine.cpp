@@ -0,0 +1,335 @@
+#include "../../headers/background_subtractor/static_background_engine.h"
+#include "../../headers/misc/thread_pool.h"
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <immintrin.h>
+#define TMD_STATIC_BGS_X86
+#endif
+
+namespace {
+    const char SNAPSHOT_MAGIC[8] = {'T', 'M', 'D', 'S', 'T', 'A', 'T', '1'};
+
+    // The accumulator keeps the background with 16 fractional bits.
+    const int FRACTION_BITS = 16;
+
+    /**
+     * Kernels computing the mask of "count" pixels (BGR). "thresholds"
+     * holds the thresholds of the channels repeated over 96 bytes, so that
+     * it can be read in the same order as the pixels, 16 or 32 bytes at a
+     * time.
+     */
+    typedef void (*subtract_kernel_t)(const uchar *image,
+                                      const uchar *background,
+                                      const uchar *thresholds, uchar *mask,
+                                      int count);
+
+    void subtract_scalar(const uchar *image, const uchar *background,
+                         const uchar *thresholds, uchar *mask, int count) {
+        for (int x = 0; x < count; x++) {
+            bool foreground = false;
+            for (int c = 0; c < 3; c++) {
+                const int diff = std::abs(image[3 * x + c] -
+                                          background[3 * x + c]);
+                foreground = foreground || diff > thresholds[c];
+            }
+            mask[x] = static_cast<uchar>(foreground ? 255 : 0);
+        }
+    }
+
+    /**
+     * Write the mask of "count" pixels from the amount by which each of
+     * their channels goes over its threshold.
+     */
+    inline void pack_exceeding(const uchar *exceeding, uchar *mask,
+                               int count) {
+        for (int i = 0; i < count; i++) {
+            mask[i] = static_cast<uchar>(
+                    (exceeding[3 * i] | exceeding[3 * i + 1] |
+                     exceeding[3 * i + 2]) ? 255 : 0);
+        }
+    }
+
+#ifdef TMD_STATIC_BGS_X86
+    __attribute__((target("sse2")))
+    void subtract_sse2(const uchar *image, const uchar *background,
+                       const uchar *thresholds, uchar *mask, int count) {
+        uchar exceeding[48];
+        int x = 0;
+        // 16 pixels are 3 vectors.
+        for (; x + 16 <= count; x += 16) {
+            for (int k = 0; k < 3; k++) {
+                const __m128i a = _mm_loadu_si128(reinterpret_cast<
+                        const __m128i *>(image + 3 * x + 16 * k));
+                const __m128i b = _mm_loadu_si128(reinterpret_cast<
+                        const __m128i *>(background + 3 * x + 16 * k));
+                const __m128i t = _mm_loadu_si128(reinterpret_cast<
+                        const __m128i *>(thresholds + 16 * k));
+                const __m128i diff = _mm_or_si128(_mm_subs_epu8(a, b),
+                                                  _mm_subs_epu8(b, a));
+                _mm_storeu_si128(reinterpret_cast<__m128i *>(
+                                         exceeding + 16 * k),
+                                 _mm_subs_epu8(diff, t));
+            }
+            pack_exceeding(exceeding, mask + x, 16);
+        }
+        subtract_scalar(image + 3 * x, background + 3 * x, thresholds,
+                        mask + x, count - x);
+    }
+
+    __attribute__((target("avx2")))
+    void subtract_avx2(const uchar *image, const uchar *background,
+                       const uchar *thresholds, uchar *mask, int count) {
+        uchar exceeding[96];
+        int x = 0;
+        // 32 pixels are 3 vectors.
+        for (; x + 32 <= count; x += 32) {
+            for (int k = 0; k < 3; k++) {
+                const __m256i a = _mm256_loadu_si256(reinterpret_cast<
+                        const __m256i *>(image + 3 * x + 32 * k));
+                const __m256i b = _mm256_loadu_si256(reinterpret_cast<
+                        const __m256i *>(background + 3 * x + 32 * k));
+                const __m256i t = _mm256_loadu_si256(reinterpret_cast<
+                        const __m256i *>(thresholds + 32 * k));
+                const __m256i diff = _mm256_or_si256(_mm256_subs_epu8(a, b),
+                                                     _mm256_subs_epu8(b, a));
+                _mm256_storeu_si256(reinterpret_cast<__m256i *>(
+                                            exceeding + 32 * k),
+                                    _mm256_subs_epu8(diff, t));
+            }
+            pack_exceeding(exceeding, mask + x, 32);
+        }
+        subtract_scalar(image + 3 * x, background + 3 * x, thresholds,
+                        mask + x, count - x);
+    }
+#endif
+
+    /**
+     * Returns the best kernel supported by the processor.
+     */
+    subtract_kernel_t select_subtract_kernel() {
+#ifdef TMD_STATIC_BGS_X86
+        __builtin_cpu_init();
+        if (__builtin_cpu_supports("avx2")) {
+            tmd::debug("StaticBackgroundEngine", "select_subtract_kernel",
+                       "AVX2");
+            return subtract_avx2;
+        }
+        if (__builtin_cpu_supports("sse2")) {
+            tmd::debug("StaticBackgroundEngine", "select_subtract_kernel",
+                       "SSE2");
+            return subtract_sse2;
+        }
+#endif
+        tmd::debug("StaticBackgroundEngine", "select_subtract_kernel",
+                   "scalar");
+        return subtract_scalar;
+    }
+
+    template <typename T>
+    void write_value(std::ofstream &file, T value) {
+        file.write(reinterpret_cast<const char *>(&value), sizeof(T));
+    }
+
+    template <typename T>
+    bool read_value(std::ifstream &file, T &value) {
+        file.read(reinterpret_cast<char *>(&value), sizeof(T));
+        return file.good();
+    }
+}
+
+namespace tmd {
+    StaticBackgroundEngine::StaticBackgroundEngine(int threshold_blue,
+                                                   int threshold_green,
+                                                   int threshold_red) {
+        m_thresholds[0] = cv::saturate_cast<uchar>(threshold_blue);
+        m_thresholds[1] = cv::saturate_cast<uchar>(threshold_green);
+        m_thresholds[2] = cv::saturate_cast<uchar>(threshold_red);
+        m_region = NULL;
+    }
+
+    void StaticBackgroundEngine::apply(const cv::Mat &image, cv::Mat &mask,
+                                       double learning_rate) {
+        if (image.type() != CV_8UC3) {
+            throw std::invalid_argument("Error : In StaticBackgroundEngine : "
+                                                "the images must be CV_8UC3");
+        }
+
+        mask.create(image.size(), CV_8U);
+        if (m_background.size() != image.size() || learning_rate >= 1) {
+            // The image becomes the background.
+            image.copyTo(m_background);
+            image.convertTo(m_accumulator, CV_32SC3, 1 << FRACTION_BITS);
+            mask.setTo(cv::Scalar::all(0));
+            return;
+        }
+
+        // Outside of the region, the pixels are background.
+        cv::Rect box(0, 0, image.cols, image.rows);
+        m_full_row.assign(1, span_t{0, image.cols});
+        if (m_region != NULL) {
+            box = m_region->get_bounding_box();
+            mask.setTo(cv::Scalar::all(0));
+        }
+
+        const int rate = learning_rate > 0 ? std::max(1, cvRound(
+                learning_rate * (1 << FRACTION_BITS))) : 0;
+
+        tmd::ThreadPool *pool = tmd::ThreadPool::get_instance();
+        const int band_count = std::max(1, std::min(box.height,
+                                                    pool->get_thread_count()));
+        std::vector<tmd::ThreadPool::task_t> tasks;
+        for (int band = 0; band < band_count; band++) {
+            const int row_begin = box.y + box.height * band / band_count;
+            const int row_end = box.y + box.height * (band + 1) / band_count;
+            tasks.push_back([this, &image, &mask, row_begin, row_end, rate]{
+                subtract_rows(image, mask, row_begin, row_end, rate);
+            });
+        }
+        pool->run_all(tasks);
+    }
+
+    void StaticBackgroundEngine::set_region(const tmd::MaskRegion *region) {
+        m_region = region;
+    }
+
+    void StaticBackgroundEngine::set_threshold(float threshold) {
+        for (int c = 0; c < 3; c++) {
+            m_thresholds[c] = cv::saturate_cast<uchar>(threshold);
+        }
+    }
+
+    void StaticBackgroundEngine::set_history(int history) {
+    }
+
+    const std::vector<tmd::span_t> &StaticBackgroundEngine::get_spans(int row) {
+        return m_region != NULL ? m_region->get_spans(row) : m_full_row;
+    }
+
+    void StaticBackgroundEngine::subtract_rows(const cv::Mat &image,
+                                               cv::Mat &mask, int begin,
+                                               int end, int rate) {
+        static const subtract_kernel_t subtract_kernel =
+                select_subtract_kernel();
+
+        uchar thresholds[96];
+        for (int i = 0; i < 96; i++) {
+            thresholds[i] = m_thresholds[i % 3];
+        }
+
+        for (int y = begin; y < end; y++) {
+            const uchar *pixels = image.ptr<uchar>(y);
+            uchar *background = m_background.ptr<uchar>(y);
+            int *accumulator = m_accumulator.ptr<int>(y);
+            uchar *mask_row = mask.ptr<uchar>(y);
+
+            for (const tmd::span_t &span : get_spans(y)) {
+                subtract_kernel(pixels + 3 * span.begin,
+                                background + 3 * span.begin, thresholds,
+                                mask_row + span.begin, span.end - span.begin);
+                if (rate == 0) {
+                    continue;
+                }
+                for (int x = span.begin; x < span.end; x++) {
+                    if (mask_row[x] != 0) {
+                        continue;
+                    }
+                    for (int i = 3 * x; i < 3 * x + 3; i++) {
+                        const long long target = static_cast<long long>(
+                                pixels[i]) << FRACTION_BITS;
+                        accumulator[i] += static_cast<int>(
+                                ((target - accumulator[i]) * rate) >>
+                                FRACTION_BITS);
+                        background[i] = cv::saturate_cast<uchar>(
+                                (accumulator[i] +
+                                 (1 << (FRACTION_BITS - 1))) >> FRACTION_BITS);
+                    }
+                }
+            }
+        }
+    }
+
+    bool StaticBackgroundEngine::save(const std::string &path,
+                                      const cv::Mat &static_mask) {
+        if (m_accumulator.empty()) {
+            return false;
+        }
+        const std::string tmp_path = path + ".tmp";
+        std::ofstream file(tmp_path, std::ios::binary);
+        if (!file.is_open()) {
+            return false;
+        }
+
+        cv::Mat accumulator = m_accumulator.isContinuous() ? m_accumulator :
+                              m_accumulator.clone();
+        file.write(SNAPSHOT_MAGIC, sizeof(SNAPSHOT_MAGIC));
+        write_value<int>(file, accumulator.cols);
+        write_value<int>(file, accumulator.rows);
+        file.write(reinterpret_cast<const char *>(accumulator.data),
+                   accumulator.total() * accumulator.elemSize());
+
+        cv::Mat mask = static_mask.isContinuous() ? static_mask :
+                       static_mask.clone();
+        write_value<int>(file, mask.rows);
+        write_value<int>(file, mask.cols);
+        write_value<int>(file, mask.type());
+        file.write(reinterpret_cast<const char *>(mask.data),
+                   mask.total() * mask.elemSize());
+
+        file.close();
+        if (file.fail()) {
+            std::remove(tmp_path.c_str());
+            return false;
+        }
+        return std::rename(tmp_path.c_str(), path.c_str()) == 0;
+    }
+
+    bool StaticBackgroundEngine::load(const std::string &path,
+                                      cv::Mat &static_mask) {
+        std::ifstream file(path, std::ios::binary);
+        if (!file.is_open()) {
+            return false;
+        }
+
+        char magic[sizeof(SNAPSHOT_MAGIC)];
+        file.read(magic, sizeof(magic));
+        if (!file.good() || memcmp(magic, SNAPSHOT_MAGIC, sizeof(magic))) {
+            return false;
+        }
+
+        int width, height;
+        if (!read_value(file, width) || !read_value(file, height) ||
+            width <= 0 || height <= 0) {
+            return false;
+        }
+
+        // Everything is read before the model is touched.
+        cv::Mat accumulator(height, width, CV_32SC3);
+        file.read(reinterpret_cast<char *>(accumulator.data),
+                  accumulator.total() * accumulator.elemSize());
+
+        int mask_rows, mask_cols, mask_type;
+        if (!read_value(file, mask_rows) || !read_value(file, mask_cols) ||
+            !read_value(file, mask_type)) {
+            return false;
+        }
+        cv::Mat new_mask;
+        if (mask_rows > 0 && mask_cols > 0) {
+            new_mask.create(mask_rows, mask_cols, mask_type);
+            file.read(reinterpret_cast<char *>(new_mask.data),
+                      new_mask.total() * new_mask.elemSize());
+        }
+        if (file.fail()) {
+            return false;
+        }
+
+        m_accumulator = accumulator;
+        m_accumulator.convertTo(m_background, CV_8UC3,
+                                1. / (1 << FRACTION_BITS));
+        static_mask = new_mask;
+        return true;
+    }
+}
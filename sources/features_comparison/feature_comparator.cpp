@@ -45,6 +45,9 @@ namespace tmd {
 
     void FeatureComparator::runClustering() {
         m_labels = m_data;
+        // The centers may be shared (see AssetRegistry), kmeans must not
+        // write in them.
+        m_centers.release();
         kmeans(m_data, m_clusterCount, m_labels, m_termCriteria, m_attempts,
                m_flags, m_centers);
         computeColorCentersIndexes();
@@ -1,5 +1,6 @@
 #include "../../headers/features_extraction/dpm.h"
 #include "../../headers/data_structures/frame_t.h"
+#include <atomic>
 
 #ifndef max
 #define max(a, b)            (((a) > (b)) ? (a) : (b))
@@ -9,21 +10,36 @@
 #define min(a, b)            (((a) < (b)) ? (a) : (b))
 #endif
 
+namespace {
+    // Negative until DPM::set_thread_count() is called.
+    std::atomic<int> thread_count(-1);
+}
+
 namespace tmd {
 
     DPM::DPM() {
-        m_detector = cvLoadLatentSvmDetector(Config::model_file_path.c_str());
+        m_detector = tmd::AssetRegistry::get_instance()->get_dpm_model(
+                Config::model_file_path);
     }
 
     DPM::~DPM() {
-        cvReleaseLatentSvmDetector(&m_detector);
+        // The model belongs to the registry.
+    }
+
+    void DPM::set_thread_count(int count) {
+        thread_count = count;
+    }
+
+    int DPM::get_thread_count() {
+        const int count = thread_count;
+        return count < 0 ? Config::dpm_detector_numthread : count;
     }
 
     std::vector<tmd::player_t *> DPM::extract_players_and_body_parts(
             tmd::frame_t *frame) {
         IplImage blobImage;
         if (tmd::Config::use_colored_mask_in_dpm){
-            blobImage = frame->colored_mask_frame;
+            blobImage = tmd::get_colored_mask(frame);
         }
         else{
             blobImage = frame->original_frame;
@@ -32,7 +48,7 @@ namespace tmd {
 
         this->cvLatentSvmDetectObjects(&blobImage, m_detector, memStorage,
 tmd::Config::dpm_extractor_overlapping_threshold,
-                                       tmd::Config::dpm_detector_numthread);
+                                       get_thread_count());
 
         // apply clamp and make part coordinates relative to the box
         clamp_detections(frame->original_frame.cols,frame->original_frame.rows);
@@ -46,7 +62,7 @@ tmd::Config::dpm_extractor_overlapping_threshold,
                 tmd::player_t *player = new player_t;
                 player->frame_index = frame->frame_index;
                 player->likelihood = score;
-                player->mask_image = frame->mask_frame(box);
+                player->mask_image = tmd::get_mask(frame)(box);
                 player->original_image = frame->original_frame(box);
                 player->pos_frame = box;
                 player->features.body_parts = parts;
@@ -91,7 +107,7 @@ tmd::Config::dpm_extractor_overlapping_threshold,
     }
 
     void DPM::cvLatentSvmDetectObjects(IplImage *image,
-                                     CvLatentSvmDetector *detector,
+                                     const CvLatentSvmDetector *detector,
                                      CvMemStorage *storage,
                                      float overlap_threshold, int numThreads) {
         CvLSVMFeaturePyramid *H = 0;
@@ -0,0 +1,110 @@
+#include "../../headers/frame_sources/frame_source.h"
+#include "../../headers/frame_sources/video_file_source.h"
+#include "../../headers/frame_sources/image_sequence_source.h"
+#include "../../headers/frame_sources/raw_file_source.h"
+#include "../../headers/frame_sources/pipe_source.h"
+
+namespace tmd {
+    FrameSource::FrameSource() {
+        m_position = 0;
+        m_replay_first_frame = false;
+    }
+
+    FrameSource::~FrameSource() {
+    }
+
+    bool FrameSource::read(cv::Mat &image) {
+        if (m_replay_first_frame) {
+            m_replay_first_frame = false;
+            image = m_first_frame.clone();
+            return true;
+        }
+        return read_image(image);
+    }
+
+    bool FrameSource::skip() {
+        if (m_replay_first_frame) {
+            m_replay_first_frame = false;
+            return true;
+        }
+        return skip_image();
+    }
+
+    bool FrameSource::seek(int index) {
+        if (index == get_position()) {
+            return true;
+        }
+        if (m_replay_first_frame) {
+            m_replay_first_frame = false;
+        }
+        if (seek_image(index)) {
+            return true;
+        }
+        if (index < m_position) {
+            return false;
+        }
+        while (m_position < index) {
+            if (!skip_image()) {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    int FrameSource::get_position() {
+        return m_replay_first_frame ? 0 : m_position;
+    }
+
+    cv::Mat FrameSource::get_first_frame() {
+        if (!m_first_frame.empty()) {
+            return m_first_frame;
+        }
+        if (m_position == 0) {
+            if (read_image(m_first_frame) && !seek_image(0)) {
+                m_replay_first_frame = true;
+            }
+        }
+        else {
+            int position = m_position;
+            if (seek_image(0)) {
+                read_image(m_first_frame);
+                seek_image(position);
+            }
+        }
+        return m_first_frame;
+    }
+
+    bool FrameSource::seek_image(int index) {
+        return false;
+    }
+
+    FrameSource *FrameSource::open(const std::string &video_folder,
+                                   int camera_index) {
+        const std::string &type = tmd::Config::frame_source_type;
+        const std::string name = "ace_" + std::to_string(camera_index);
+        const int width = tmd::Config::frame_source_width;
+        const int height = tmd::Config::frame_source_height;
+        const double fps = tmd::Config::frame_source_fps;
+
+        tmd::debug("FrameSource", "open", "Opening a " + type + " source for "
+                "camera " + std::to_string(camera_index));
+        if (type == "video") {
+            return new VideoFileSource(video_folder + name + ".mp4");
+        }
+        else if (type == "images") {
+            return new ImageSequenceSource(video_folder + name + "/",
+                                   tmd::Config::frame_source_image_format, fps);
+        }
+        else if (type == "raw") {
+            return new RawFileSource(video_folder + name + ".raw", width,
+                                     height,
+                                     tmd::Config::frame_source_raw_format, fps);
+        }
+        else if (type == "pipe") {
+            return new PipeSource(width, height,
+                                  tmd::Config::frame_source_raw_format, fps);
+        }
+        throw std::invalid_argument("Error : unknown frame source type " +
+                                    type);
+    }
+}
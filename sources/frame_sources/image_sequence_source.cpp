@@ -0,0 +1,62 @@
+#include <cstdio>
+#include <fstream>
+#include <vector>
+#include "../../headers/frame_sources/image_sequence_source.h"
+
+namespace tmd {
+    ImageSequenceSource::ImageSequenceSource(const std::string &folder,
+                                             const std::string &name_format,
+                                             double fps) {
+        m_folder = folder;
+        m_name_format = name_format;
+        m_fps = fps;
+
+        cv::Mat first_image = cv::imread(get_image_path(0));
+        if (first_image.empty()) {
+            throw std::invalid_argument("Error couldn't load the image " +
+                                        get_image_path(0));
+        }
+        m_size = first_image.size();
+    }
+
+    double ImageSequenceSource::get_fps() {
+        return m_fps;
+    }
+
+    cv::Size ImageSequenceSource::get_size() {
+        return m_size;
+    }
+
+    int ImageSequenceSource::get_frame_count() {
+        return -1;
+    }
+
+    bool ImageSequenceSource::read_image(cv::Mat &image) {
+        image = cv::imread(get_image_path(m_position));
+        if (image.empty()) {
+            return false;
+        }
+        m_position++;
+        return true;
+    }
+
+    bool ImageSequenceSource::skip_image() {
+        std::ifstream image_file(get_image_path(m_position));
+        if (!image_file.good()) {
+            return false;
+        }
+        m_position++;
+        return true;
+    }
+
+    bool ImageSequenceSource::seek_image(int index) {
+        m_position = index;
+        return true;
+    }
+
+    std::string ImageSequenceSource::get_image_path(int index) {
+        std::vector<char> name(m_name_format.size() + 32);
+        snprintf(name.data(), name.size(), m_name_format.c_str(), index);
+        return m_folder + name.data();
+    }
+}
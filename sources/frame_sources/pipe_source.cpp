@@ -0,0 +1,8 @@
+#include "../../headers/frame_sources/pipe_source.h"
+
+namespace tmd {
+    PipeSource::PipeSource(int width, int height, const std::string &format,
+                           double fps)
+            : RawFileSource(stdin, false, width, height, format, fps) {
+    }
+}
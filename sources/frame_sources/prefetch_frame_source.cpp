@@ -0,0 +1,92 @@
+#include "../../headers/frame_sources/prefetch_frame_source.h"
+
+namespace tmd {
+    PrefetchFrameSource::PrefetchFrameSource(FrameSource *source, int step,
+                                             int capacity) {
+        if (step <= 0 || capacity <= 0) {
+            throw std::invalid_argument("Error : In PrefetchFrameSource : "
+                                                "invalid step or capacity");
+        }
+        m_source = source;
+        m_step = step;
+        m_capacity = capacity;
+        m_fps = source->get_fps();
+        m_size = source->get_size();
+        m_frame_count = source->get_frame_count();
+        m_position = source->get_position();
+        m_ring = NULL;
+        start();
+    }
+
+    PrefetchFrameSource::~PrefetchFrameSource() {
+        stop();
+        delete m_source;
+    }
+
+    double PrefetchFrameSource::get_fps() {
+        return m_fps;
+    }
+
+    cv::Size PrefetchFrameSource::get_size() {
+        return m_size;
+    }
+
+    int PrefetchFrameSource::get_frame_count() {
+        return m_frame_count;
+    }
+
+    bool PrefetchFrameSource::read_image(cv::Mat &image) {
+        if (m_end_reached || !m_ring->pop(image) || image.empty()) {
+            m_end_reached = true;
+            return false;
+        }
+        m_position += m_step;
+        return true;
+    }
+
+    bool PrefetchFrameSource::skip_image() {
+        cv::Mat dropped;
+        return read_image(dropped);
+    }
+
+    bool PrefetchFrameSource::seek_image(int index) {
+        stop();
+        bool sought = m_source->seek(index);
+        m_position = m_source->get_position();
+        start();
+        return sought;
+    }
+
+    void PrefetchFrameSource::start() {
+        m_ring = new tmd::SPSCRing<cv::Mat>(m_capacity);
+        m_stop_request = false;
+        m_end_reached = false;
+        m_worker = std::thread(&PrefetchFrameSource::decode, std::ref(*this));
+    }
+
+    void PrefetchFrameSource::stop() {
+        m_stop_request = true;
+        m_ring->close();
+        m_worker.join();
+        delete m_ring;
+        m_ring = NULL;
+    }
+
+    void PrefetchFrameSource::decode() {
+        while (!m_stop_request) {
+            cv::Mat image;
+            if (!m_source->read(image)) {
+                break;
+            }
+            if (!m_ring->push(image)) {
+                return;
+            }
+            for (int i = 0; i < m_step - 1; i++) {
+                if (!m_source->skip()) {
+                    break;
+                }
+            }
+        }
+        m_ring->push(cv::Mat()); // Indicating the end.
+    }
+}
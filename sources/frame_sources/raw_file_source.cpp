@@ -0,0 +1,130 @@
+#include "../../headers/frame_sources/raw_file_source.h"
+
+namespace tmd {
+    RawFileSource::RawFileSource(const std::string &file_path, int width,
+                                 int height, const std::string &format,
+                                 double fps) {
+        m_stream = fopen(file_path.c_str(), "rb");
+        if (m_stream == NULL) {
+            throw std::invalid_argument("Error couldn't open the raw file " +
+                                        file_path);
+        }
+        m_owns_stream = true;
+        m_seekable = true;
+        init(width, height, format, fps);
+    }
+
+    RawFileSource::RawFileSource(FILE *stream, bool seekable, int width,
+                                 int height, const std::string &format,
+                                 double fps) {
+        m_stream = stream;
+        m_owns_stream = false;
+        m_seekable = seekable;
+        init(width, height, format, fps);
+    }
+
+    void RawFileSource::init(int width, int height, const std::string &format,
+                             double fps) {
+        if (width <= 0 || height <= 0) {
+            throw std::invalid_argument("Error : In RawFileSource : invalid "
+                                                "image size");
+        }
+        if (format == "bgr") {
+            m_is_yuv = false;
+            m_image_bytes = (size_t) width * height * 3;
+        }
+        else if (format == "i420") {
+            if (width % 2 != 0 || height % 2 != 0) {
+                throw std::invalid_argument("Error : In RawFileSource : odd "
+                                                    "image size in i420");
+            }
+            m_is_yuv = true;
+            m_image_bytes = (size_t) width * height * 3 / 2;
+        }
+        else {
+            throw std::invalid_argument("Error : In RawFileSource : unknown "
+                                                "format " + format);
+        }
+        m_width = width;
+        m_height = height;
+        m_fps = fps;
+
+        // The size of the file is found once, skip_image() checks it for
+        // every image.
+        m_frame_count = -1;
+        if (m_seekable) {
+            long position = ftell(m_stream);
+            fseek(m_stream, 0, SEEK_END);
+            long size = ftell(m_stream);
+            fseek(m_stream, position, SEEK_SET);
+            m_frame_count = (int) (size / m_image_bytes);
+        }
+    }
+
+    RawFileSource::~RawFileSource() {
+        if (m_owns_stream) {
+            fclose(m_stream);
+        }
+    }
+
+    double RawFileSource::get_fps() {
+        return m_fps;
+    }
+
+    cv::Size RawFileSource::get_size() {
+        return cv::Size(m_width, m_height);
+    }
+
+    int RawFileSource::get_frame_count() {
+        return m_frame_count;
+    }
+
+    bool RawFileSource::read_image(cv::Mat &image) {
+        // A new buffer every time, the previous images may still be in use.
+        cv::Mat raw;
+        if (m_is_yuv) {
+            raw.create(m_height * 3 / 2, m_width, CV_8UC1);
+        }
+        else {
+            raw.create(m_height, m_width, CV_8UC3);
+        }
+        if (fread(raw.data, 1, m_image_bytes, m_stream) != m_image_bytes) {
+            return false;
+        }
+        if (m_is_yuv) {
+            cv::cvtColor(raw, image, CV_YUV2BGR_I420);
+        }
+        else {
+            image = raw;
+        }
+        m_position++;
+        return true;
+    }
+
+    bool RawFileSource::skip_image() {
+        if (m_seekable) {
+            if (m_frame_count <= m_position) {
+                return false;
+            }
+            fseek(m_stream, (long) m_image_bytes, SEEK_CUR);
+        }
+        else {
+            m_skip_buffer.resize(m_image_bytes);
+            if (fread(m_skip_buffer.data(), 1, m_image_bytes, m_stream) !=
+                m_image_bytes) {
+                return false;
+            }
+        }
+        m_position++;
+        return true;
+    }
+
+    bool RawFileSource::seek_image(int index) {
+        if (!m_seekable) {
+            return false;
+        }
+        fseek(m_stream, (long) (index * m_image_bytes), SEEK_SET);
+        m_position = index;
+        return true;
+    }
+}
@@ -0,0 +1,51 @@
+#include "../../headers/frame_sources/video_file_source.h"
+
+namespace tmd {
+    VideoFileSource::VideoFileSource(const std::string &video_path) {
+        m_video.open(video_path);
+        if (!m_video.isOpened()) {
+            throw std::invalid_argument("Error couldn't load the video " +
+                                        video_path);
+        }
+    }
+
+    VideoFileSource::~VideoFileSource() {
+        m_video.release();
+    }
+
+    double VideoFileSource::get_fps() {
+        return m_video.get(CV_CAP_PROP_FPS);
+    }
+
+    cv::Size VideoFileSource::get_size() {
+        return cv::Size((int) m_video.get(CV_CAP_PROP_FRAME_WIDTH),
+                        (int) m_video.get(CV_CAP_PROP_FRAME_HEIGHT));
+    }
+
+    int VideoFileSource::get_frame_count() {
+        return (int) m_video.get(CV_CAP_PROP_FRAME_COUNT);
+    }
+
+    bool VideoFileSource::read_image(cv::Mat &image) {
+        if (!m_video.read(image)) {
+            return false;
+        }
+        m_position++;
+        return true;
+    }
+
+    bool VideoFileSource::skip_image() {
+        // grab() demuxes the frame without converting it to BGR.
+        if (!m_video.grab()) {
+            return false;
+        }
+        m_position++;
+        return true;
+    }
+
+    bool VideoFileSource::seek_image(int index) {
+        m_video.set(CV_CAP_PROP_POS_FRAMES, index);
+        m_position = index;
+        return true;
+    }
+}
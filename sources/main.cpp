@@ -1,15 +1,26 @@
 #include <iostream>
+#include <fstream>
 #include "../headers/data_structures/frame_t.h"
 #include "../headers/background_subtractor/bgsubstractor.h"
 #include "../headers/features_extraction/dpm.h"
 #include "../headers/pipelines/pipeline.h"
 #include "../headers/pipelines/multithreaded_pipeline.h"
 #include "../headers/tools/training_set_creator.h"
+#include "../headers/tools/labeler_tester.h"
+#include "../headers/tools/cleanup_tester.h"
 #include "../headers/pipelines/approximative_pipeline.h"
+#include "../headers/pipelines/staged_pipeline.h"
+#include "../headers/pipelines/multi_camera_pipeline.h"
+#include "../headers/pipelines/shard_coordinator.h"
+#include "../headers/frame_sources/frame_source.h"
+#include "../headers/output/output_sink.h"
 #include "../headers/data_structures/cmd_args_t.h"
 
 tmd::cmd_args_t *parse_args(int argc, char *argv[]);
 void run_test();
+void run_multi_camera(tmd::cmd_args_t *args);
+bool run_shards(tmd::cmd_args_t *args);
+void write_frame_log(std::ofstream &log, tmd::frame_t *frame);
 void create_training_set(std::string video_folder,
              int camera_index, int start_frame, int end_frame, int step_size);
 
@@ -24,6 +35,18 @@ int main(int argc, char *argv[]) {
         return EXIT_SUCCESS;
     }
 
+    if (args->labeler_test){
+        bool success = tmd::LabelerTester::test_labeler(2000, 7);
+        delete args;
+        return success ? EXIT_SUCCESS : EXIT_FAILURE;
+    }
+
+    if (args->cleanup_test){
+        bool success = tmd::CleanupTester::test_cleanup(2000, 7);
+        delete args;
+        return success ? EXIT_SUCCESS : EXIT_FAILURE;
+    }
+
     // If the user forgot the '/' ...
     if (args->video_folder[args->video_folder.size()-1] != '/'){
         args->video_folder += '/';
@@ -37,17 +60,34 @@ int main(int argc, char *argv[]) {
     }
 
     tmd::Config::load_config();
+    if (args->warmup >= 0) {
+        tmd::Config::bgs_warmup_frames = args->warmup;
+    }
+    if (args->no_checkpoints) {
+        tmd::Config::bgs_save_checkpoints = false;
+    }
+
+    if (args->shards > 1) {
+        bool success = run_shards(args);
+        delete args;
+        return success ? EXIT_SUCCESS : EXIT_FAILURE;
+    }
+
+    if (!args->cameras.empty()) {
+        run_multi_camera(args);
+        delete args;
+        return EXIT_SUCCESS;
+    }
 
     /* The pipeline of the algorithm. */
     tmd::Pipeline *pipeline = NULL;
-    SDL_Window *window = NULL;
-    cv::VideoWriter *writer = NULL;
     bool use_approximate_pipeline;
 
-    if (args->b > 1) {
+    if (args->b > 1 || args->adaptive) {
         pipeline = new tmd::ApproximativePipeline(args->video_folder,
                                                   args->camera_index, args->t,
-                                                  args->s, args->e, args->b);
+                                                  args->s, args->e, args->b,
+                                                  args->adaptive);
         use_approximate_pipeline = true;
     }
     else {
@@ -57,6 +97,11 @@ int main(int argc, char *argv[]) {
                                                args->camera_index, args->s,
                                                args->e, args->j);
         }
+        else if (args->t > 1 && args->staged) {
+            pipeline = new tmd::StagedPipeline(args->video_folder,
+                                               args->camera_index, args->t,
+                                               args->s, args->e, args->j);
+        }
         else if (args->t > 1) {
             pipeline = new tmd::MultithreadedPipeline(args->video_folder,
                                                       args->camera_index,
@@ -70,30 +115,40 @@ int main(int argc, char *argv[]) {
         }
     }
 
-    if (tmd::Config::show_results) {
-        window = tmd::SDLBinds::create_sdl_window("TMD");
-    }
-
+    std::string video_path = "";
+    double writer_fps = 0;
+    cv::Size size;
     if (tmd::Config::save_results){
-        cv::VideoCapture original_video(args->video_folder + "/ace_" +
-                            std::to_string(args->camera_index) + ".mp4");
-        double fps = original_video.get(CV_CAP_PROP_FPS);
-
-        cv::Size size((int)(original_video.get(CV_CAP_PROP_FRAME_WIDTH)),
-                      (int)(original_video.get(CV_CAP_PROP_FRAME_HEIGHT)));
-
-        std::string video_path = "result.avi";
+        tmd::FrameSource *original_video = tmd::FrameSource::open(
+                args->video_folder, args->camera_index);
+        double fps = original_video->get_fps();
+        size = original_video->get_size();
+        delete original_video;
+
+        video_path = "result.avi";
+        if (!args->shard_output.empty()) {
+            video_path = args->shard_output + ".avi";
+        }
 
-        double writer_fps;
         if (use_approximate_pipeline){
             writer_fps = fps;
         }
         else{
             writer_fps = fps / args->j;
         }
-
-        writer = new cv::VideoWriter(video_path, CV_FOURCC('M', 'P', '4', 'V')
-                , writer_fps, size, true);
+    }
+    std::string frame_prefix = "";
+    if (tmd::Config::save_all_frames){
+        frame_prefix = "./frames/frame";
+    }
+    tmd::OutputSink *sink = new tmd::OutputSink(video_path, writer_fps, size,
+                                                frame_prefix,
+                                                tmd::Config::show_results);
+
+    // The shard processes also log their results, merged by the coordinator.
+    std::ofstream log;
+    if (!args->shard_output.empty()) {
+        log.open(args->shard_output + ".log");
     }
 
     tmd::frame_t *frame = pipeline->next_frame();
@@ -101,44 +156,33 @@ int main(int argc, char *argv[]) {
     std::cout << "Begin" << std::endl;
     double t1 = cv::getTickCount();
     while (frame != NULL) {
-        cv::Mat result = tmd::draw_player_on_frame(0, frame);
-
-        if (tmd::Config::show_results) {
-            tmd::SDLBinds::imshow(window, result);
-        }
+        cv::Mat result = tmd::draw_player_on_frame(
+                tmd::Config::results_image, frame);
 
         if (tmd::Config::save_results) {
             std::cout << "Write frame " << frame->frame_index << std::endl;
-            writer->write(result);
         }
 
         if (tmd::Config::save_all_frames){
-            std::string file_name = "./frames/frame" + std::to_string(
-                                                   frame->frame_index) + ".jpg";
             std::cout << "Save frame " << frame->frame_index << std::endl;
-            cv::imwrite(file_name, result);
+        }
+        sink->write(result, frame->frame_index);
+        if (log.is_open()) {
+            write_frame_log(log, frame);
         }
 
+        std::cout << "Frame " << frame->frame_index << " done" << std::endl;
         if (!use_approximate_pipeline) {
             free_frame(frame);
         }
-        std::cout << "Frame " << frame->frame_index << " done" << std::endl;
         frame = pipeline->next_frame();
     }
+    delete sink; // Waits for the last frames to be written.
     double t2 = cv::getTickCount();
 
     std::cout << "Done" << std::endl;
     std::cout << "Time = " << (t2 - t1) / cv::getTickFrequency() << std::endl;
 
-    if (tmd::Config::show_results) {
-        tmd::SDLBinds::destroy_sdl_window(window);
-        tmd::SDLBinds::quit_sdl();
-    }
-
-    if (tmd::Config::save_results){
-        delete writer;
-    }
-
     delete args;
     delete pipeline;
     return EXIT_SUCCESS;
@@ -153,6 +197,19 @@ tmd::cmd_args_t *parse_args(int argc, char *argv[]) {
     }
     else if (!strcmp(argv[1], "--test")){
         args->test_run = true;
+        if (argc > 2) {
+            // Optional downscale factor of the bgs to test.
+            tmd::Config::bgs_downscale_factor =
+                    static_cast<int>(strtol(argv[2], NULL, 10));
+        }
+        return args;
+    }
+    else if (!strcmp(argv[1], "--test-labeler")){
+        args->labeler_test = true;
+        return args;
+    }
+    else if (!strcmp(argv[1], "--test-cleanup")){
+        args->cleanup_test = true;
         return args;
     }
 
@@ -162,6 +219,7 @@ tmd::cmd_args_t *parse_args(int argc, char *argv[]) {
         return NULL;
     }
 
+    args->program = argv[0];
     args->video_folder = argv[1];
     args->camera_index = static_cast<int> (strtol(argv[2], NULL, 10));
 
@@ -172,6 +230,61 @@ tmd::cmd_args_t *parse_args(int argc, char *argv[]) {
         else if (!strcmp(argv[i], "--train")) {
             args->training_set_creator = true;
         }
+        else if (!strcmp(argv[i], "--staged")) {
+            args->staged = true;
+        }
+        else if (!strcmp(argv[i], "--adaptive")) {
+            args->adaptive = true;
+        }
+        else if (!strcmp(argv[i], "--cameras")) {
+            if (i == argc - 1) {
+                std::cout << "Error, expected camera indices." << std::endl;
+                return NULL;
+            }
+            else {
+                i++;
+                // Comma separated list, e.g. 0,1,2,3.
+                char *index = strtok(argv[i], ",");
+                while (index != NULL) {
+                    args->cameras.push_back(
+                            static_cast<int>(strtol(index, NULL, 10)));
+                    index = strtok(NULL, ",");
+                }
+            }
+        }
+        else if (!strcmp(argv[i], "--shards")) {
+            if (i == argc - 1) {
+                std::cout << "Error, expected shard count." << std::endl;
+                return NULL;
+            }
+            else {
+                i++;
+                args->shards = static_cast<int>(strtol(argv[i], NULL, 10));
+            }
+        }
+        else if (!strcmp(argv[i], "--warmup")) {
+            if (i == argc - 1) {
+                std::cout << "Error, expected warm-up length." << std::endl;
+                return NULL;
+            }
+            else {
+                i++;
+                args->warmup = static_cast<int>(strtol(argv[i], NULL, 10));
+            }
+        }
+        else if (!strcmp(argv[i], "--no-checkpoints")) {
+            args->no_checkpoints = true;
+        }
+        else if (!strcmp(argv[i], "--shard-output")) {
+            if (i == argc - 1) {
+                std::cout << "Error, expected shard output." << std::endl;
+                return NULL;
+            }
+            else {
+                i++;
+                args->shard_output = argv[i];
+            }
+        }
         else if (!strcmp(argv[i], "-s")) {
             if (i == argc - 1) {
                 std::cout << "Error, expected starting frame." << std::endl;
@@ -268,4 +381,93 @@ void run_test(){
         free_frame(frame);
         frame = pipeline.next_frame();
     }
+}
+
+void run_multi_camera(tmd::cmd_args_t *args) {
+    tmd::MultiCameraPipeline pipeline(args->video_folder, args->cameras,
+                                      args->s, args->e, args->j);
+    std::vector<tmd::OutputSink *> sinks;
+
+    for (size_t i = 0; i < args->cameras.size(); i++) {
+        int camera_index = args->cameras[i];
+        std::string video_path = "";
+        double fps = 0;
+        cv::Size size;
+        if (tmd::Config::save_results) {
+            tmd::FrameSource *original_video = tmd::FrameSource::open(
+                    args->video_folder, camera_index);
+            fps = original_video->get_fps() / args->j;
+            size = original_video->get_size();
+            delete original_video;
+            video_path = "result_" + std::to_string(camera_index) + ".avi";
+        }
+        std::string frame_prefix = "";
+        if (tmd::Config::save_all_frames) {
+            frame_prefix = "./frames/frame" + std::to_string(camera_index) +
+                           "_";
+        }
+        // Only the first camera is shown.
+        sinks.push_back(new tmd::OutputSink(video_path, fps, size,
+                                            frame_prefix,
+                                            tmd::Config::show_results &&
+                                            i == 0));
+    }
+
+    std::cout << "Begin" << std::endl;
+    double t1 = cv::getTickCount();
+    std::vector<tmd::frame_t *> frames = pipeline.next_frames();
+    while (!frames.empty()) {
+        for (size_t i = 0; i < frames.size(); i++) {
+            tmd::frame_t *frame = frames[i];
+            cv::Mat result = tmd::draw_player_on_frame(
+                    tmd::Config::results_image, frame);
+            sinks[i]->write(result, frame->frame_index);
+        }
+        std::cout << "Frame " << frames[0]->frame_index << " done" <<
+        std::endl;
+        for (tmd::frame_t *frame : frames) {
+            free_frame(frame);
+        }
+        frames = pipeline.next_frames();
+    }
+    for (tmd::OutputSink *sink : sinks) {
+        delete sink; // Waits for the last frames to be written.
+    }
+    double t2 = cv::getTickCount();
+
+    std::cout << "Done" << std::endl;
+    std::cout << "Time = " << (t2 - t1) / cv::getTickFrequency() << std::endl;
+}
+
+bool run_shards(tmd::cmd_args_t *args) {
+    if (args->b > 1 || args->adaptive || !args->cameras.empty()) {
+        std::cout << "Error, --shards can not be used with -b, --adaptive or "
+                "--cameras." << std::endl;
+        return false;
+    }
+    tmd::ShardCoordinator coordinator(args->program, args->video_folder,
+                                      args->camera_index, args->s, args->e,
+                                      args->j, args->shards);
+
+    std::cout << "Begin" << std::endl;
+    double t1 = cv::getTickCount();
+    bool success = coordinator.run("result.log", tmd::Config::save_results ?
+                                                 "result.avi" : "");
+    double t2 = cv::getTickCount();
+
+    std::cout << (success ? "Done" : "Failed") << std::endl;
+    std::cout << "Time = " << (t2 - t1) / cv::getTickFrequency() << std::endl;
+    return success;
+}
+
+void write_frame_log(std::ofstream &log, tmd::frame_t *frame) {
+    // One line per frame : its index, the number of players and for each
+    // player its box and team.
+    log << frame->frame_index << " " << frame->players.size();
+    for (tmd::player_t *player : frame->players) {
+        const cv::Rect &box = player->pos_frame;
+        log << " " << box.x << " " << box.y << " " << box.width << " " <<
+        box.height << " " << player->team;
+    }
+    log << std::endl;
 }
\ No newline at end of file
@@ -0,0 +1,61 @@
+#include "../../headers/misc/asset_registry.h"
+#include "../../headers/features_comparison/feature_comparator.h"
+#include <opencv2/highgui/highgui.hpp>
+
+namespace tmd {
+    AssetRegistry::~AssetRegistry() {
+        for (auto &model : m_dpm_models) {
+            cvReleaseLatentSvmDetector(&model.second);
+        }
+    }
+
+    const CvLatentSvmDetector *AssetRegistry::get_dpm_model(
+            const std::string &path) {
+        std::lock_guard<std::mutex> lock(m_lock);
+        auto found = m_dpm_models.find(path);
+        if (found != m_dpm_models.end()) {
+            return found->second;
+        }
+        CvLatentSvmDetector *model = cvLoadLatentSvmDetector(path.c_str());
+        if (model == NULL) {
+            throw std::invalid_argument("Error in AssetRegistry, couldn't "
+                                                "load the DPM model " + path);
+        }
+        tmd::debug("AssetRegistry", "get_dpm_model", path + " loaded.");
+        m_dpm_models[path] = model;
+        return model;
+    }
+
+    cv::Mat AssetRegistry::get_image(const std::string &path, int flags) {
+        std::lock_guard<std::mutex> lock(m_lock);
+        const std::pair<std::string, int> key(path, flags);
+        auto found = m_images.find(key);
+        if (found != m_images.end()) {
+            return found->second;
+        }
+        // A missing file is remembered as well, it is not read again.
+        cv::Mat image = cv::imread(path, flags);
+        tmd::debug("AssetRegistry", "get_image", path + (image.empty() ?
+                " not found." : " loaded."));
+        m_images[key] = image;
+        return image;
+    }
+
+    cv::Mat AssetRegistry::get_centers() {
+        std::lock_guard<std::mutex> lock(m_lock);
+        const std::string &path = tmd::Config::
+                features_comparator_centers_file_name;
+        auto found = m_centers.find(path);
+        if (found != m_centers.end()) {
+            return found->second;
+        }
+        cv::Mat centers = tmd::FeatureComparator::readCentersFromFile();
+        m_centers[path] = centers;
+        return centers;
+    }
+
+    AssetRegistry *AssetRegistry::get_instance() {
+        static AssetRegistry instance;
+        return &instance;
+    }
+}
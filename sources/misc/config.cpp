@@ -47,6 +47,16 @@ namespace tmd {
         load_value(bgs_blob_buffer_size);
         load_value(bgs_blob_threshold_count);
         load_value(bgs_learning_rate);
+        load_value(bgs_checkpoint_interval);
+        load_value(bgs_checkpoint_folder);
+        load_value(bgs_save_checkpoints);
+        load_value(bgs_warmup_frames);
+        load_value(bgs_downscale_factor);
+        load_value(bgs_update_interval);
+        load_value(bgs_engine);
+        load_value(bgs_static_threshold_blue);
+        load_value(bgs_static_threshold_green);
+        load_value(bgs_static_threshold_red);
         //load_value(bgs_empty_room_background);
         //load_value(calibration_tool_escape_char);
         load_value(dpm_detector_numthread);
@@ -79,7 +89,25 @@ namespace tmd {
         load_value(show_blobs);
         load_value(show_player_team);
         load_value(save_all_frames);
+        load_value(results_image);
         load_value(use_empty_room_images_as_background);
+        load_value(pipeline_buffer_size);
+        load_value(thread_pool_size);
+        load_value(multi_camera_max_skew);
+        load_value(frame_source_type);
+        load_value(frame_source_image_format);
+        load_value(frame_source_raw_format);
+        load_value(frame_source_width);
+        load_value(frame_source_height);
+        load_value(frame_source_fps);
+        load_value(frame_source_prefetch_size);
+        load_value(output_queue_size);
+        load_value(output_jpeg_threads);
+        load_value(controller_target_latency);
+        load_value(controller_window);
+        load_value(controller_max_box_step);
+        load_value(controller_max_blob_size);
+        load_value(controller_max_dpm_threads);
 
         tmd::debug("Config", "load_config", "Config file loaded.");
     }
@@ -109,6 +137,7 @@ namespace tmd {
     bool Config::show_blobs = false;
     bool Config::show_player_team = true;
     bool Config::save_all_frames = false;
+    int Config::results_image = 0;
 
     /**********************************************************************/
     /* BGS                                                                */
@@ -122,6 +151,16 @@ namespace tmd {
     std::string Config::bgs_empty_room_background = "./res/room_background/";
     bool Config::use_empty_room_images_as_background = false;
     bool Config::use_bgs = true;
+    int Config::bgs_checkpoint_interval = 0; // 0 disables the snapshots.
+    std::string Config::bgs_checkpoint_folder = "./checkpoints/";
+    bool Config::bgs_save_checkpoints = true; // false to only restore them.
+    int Config::bgs_warmup_frames = 0;
+    int Config::bgs_downscale_factor = 1; // 1 for the full resolution.
+    int Config::bgs_update_interval = 0; // 0 for the computed frames.
+    std::string Config::bgs_engine = "mog2"; // Or static.
+    int Config::bgs_static_threshold_blue = 30;
+    int Config::bgs_static_threshold_green = 30;
+    int Config::bgs_static_threshold_red = 30;
 
     /**********************************************************************/
     /* Calibration tool                                                   */
@@ -169,4 +208,37 @@ namespace tmd {
     /**********************************************************************/
     int Config::blob_player_extractor_buffer_size = 5; // Must be odd
     int Config::blob_player_extractor_min_blob_size = 500;
+
+    /**********************************************************************/
+    /* Pipelines                                                          */
+    /**********************************************************************/
+    int Config::pipeline_buffer_size = 4; // Frames decoded ahead per thread.
+    int Config::thread_pool_size = 0; // 0 means one thread per core.
+    int Config::multi_camera_max_skew = 2; // Frames ready ahead per camera.
+
+    /**********************************************************************/
+    /* Frame sources                                                      */
+    /**********************************************************************/
+    std::string Config::frame_source_type = "video"; // video/images/raw/pipe
+    std::string Config::frame_source_image_format = "%06d.jpg";
+    std::string Config::frame_source_raw_format = "bgr"; // Or i420.
+    int Config::frame_source_width = 0; // Needed by raw and pipe sources.
+    int Config::frame_source_height = 0;
+    float Config::frame_source_fps = 25.0f; // All but video.
+    int Config::frame_source_prefetch_size = 4; // 0 disables prefetching.
+
+    /**********************************************************************/
+    /* Output sink                                                        */
+    /**********************************************************************/
+    int Config::output_queue_size = 16; // Results waiting to be written.
+    int Config::output_jpeg_threads = 2;
+
+    /**********************************************************************/
+    /* Real time controller                                               */
+    /**********************************************************************/
+    float Config::controller_target_latency = 0.5f; // In seconds.
+    int Config::controller_window = 10; // Box sets between two adjustments.
+    int Config::controller_max_box_step = 50;
+    int Config::controller_max_blob_size = 2000;
+    int Config::controller_max_dpm_threads = 0; // 0 for one per core.
 }
\ No newline at end of file
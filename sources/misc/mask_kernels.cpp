@@ -0,0 +1,126 @@
+#include "../../headers/misc/mask_kernels.h"
+#include <algorithm>
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <immintrin.h>
+#define TMD_MASK_KERNELS_X86
+#endif
+
+namespace {
+    /**
+     * Kernels masking "count" pixels (BGR) of a row. "static_mask" is NULL
+     * if there is none.
+     */
+    typedef void (*mask_kernel_t)(const uchar *image, const uchar *mask,
+                                  const uchar *static_mask, uchar threshold,
+                                  uchar *output, int count);
+
+    void mask_scalar(const uchar *image, const uchar *mask,
+                     const uchar *static_mask, uchar threshold,
+                     uchar *output, int count) {
+        for (int x = 0; x < count; x++) {
+            const bool keep = mask[x] >= threshold &&
+                              (static_mask == NULL || static_mask[x] != 0);
+            for (int c = 3 * x; c < 3 * x + 3; c++) {
+                output[c] = keep ? image[c] : static_cast<uchar>(0);
+            }
+        }
+    }
+
+#ifdef TMD_MASK_KERNELS_X86
+    __attribute__((target("ssse3")))
+    void mask_ssse3(const uchar *image, const uchar *mask,
+                    const uchar *static_mask, uchar threshold, uchar *output,
+                    int count) {
+        // Spread the 16 mask bytes on the 48 bytes of their pixels.
+        const __m128i spread[3] = {
+                _mm_setr_epi8(0, 0, 0, 1, 1, 1, 2, 2, 2, 3, 3, 3, 4, 4, 4, 5),
+                _mm_setr_epi8(5, 5, 6, 6, 6, 7, 7, 7, 8, 8, 8, 9, 9, 9, 10,
+                              10),
+                _mm_setr_epi8(10, 11, 11, 11, 12, 12, 12, 13, 13, 13, 14, 14,
+                              14, 15, 15, 15)};
+        const __m128i t = _mm_set1_epi8(static_cast<char>(threshold));
+        const __m128i zero = _mm_setzero_si128();
+        int x = 0;
+        for (; x + 16 <= count; x += 16) {
+            const __m128i m = _mm_loadu_si128(reinterpret_cast<
+                    const __m128i *>(mask + x));
+            // m >= threshold, as unsigned bytes.
+            __m128i keep = _mm_cmpeq_epi8(_mm_max_epu8(m, t), m);
+            if (static_mask != NULL) {
+                const __m128i s = _mm_loadu_si128(reinterpret_cast<
+                        const __m128i *>(static_mask + x));
+                keep = _mm_andnot_si128(_mm_cmpeq_epi8(s, zero), keep);
+            }
+            for (int k = 0; k < 3; k++) {
+                const __m128i pixels = _mm_loadu_si128(reinterpret_cast<
+                        const __m128i *>(image + 3 * x + 16 * k));
+                _mm_storeu_si128(reinterpret_cast<__m128i *>(
+                                         output + 3 * x + 16 * k),
+                                 _mm_and_si128(pixels, _mm_shuffle_epi8(
+                                         keep, spread[k])));
+            }
+        }
+        mask_scalar(image + 3 * x, mask + x,
+                    static_mask != NULL ? static_mask + x : NULL, threshold,
+                    output + 3 * x, count - x);
+    }
+#endif
+
+    /**
+     * Returns the best kernel supported by the processor.
+     */
+    mask_kernel_t select_mask_kernel() {
+#ifdef TMD_MASK_KERNELS_X86
+        __builtin_cpu_init();
+        if (__builtin_cpu_supports("ssse3")) {
+            tmd::debug("mask_kernels", "select_mask_kernel", "SSSE3");
+            return mask_ssse3;
+        }
+#endif
+        tmd::debug("mask_kernels", "select_mask_kernel", "scalar");
+        return mask_scalar;
+    }
+}
+
+namespace tmd {
+    void apply_masks(const cv::Mat &image, const cv::Mat &mask,
+                     const cv::Mat &static_mask, int threshold,
+                     cv::Mat &output, const cv::Rect &roi) {
+        static const mask_kernel_t mask_kernel = select_mask_kernel();
+
+        if (image.type() != CV_8UC3 || mask.type() != CV_8U ||
+            mask.size() != image.size() ||
+            (!static_mask.empty() && (static_mask.type() != CV_8U ||
+                                      static_mask.size() != image.size()))) {
+            throw std::invalid_argument("Error : In apply_masks : the images "
+                                                "don't match");
+        }
+
+        const cv::Rect full(0, 0, image.cols, image.rows);
+        const cv::Rect box = roi.area() > 0 ? roi & full : full;
+        const bool in_place = output.data == image.data;
+        if (!in_place) {
+            output.create(image.size(), image.type());
+        }
+
+        // Around the box.
+        const cv::Scalar black = cv::Scalar::all(0);
+        output(cv::Rect(0, 0, image.cols, box.y)).setTo(black);
+        output(cv::Rect(0, box.y + box.height, image.cols,
+                        image.rows - box.y - box.height)).setTo(black);
+        output(cv::Rect(0, box.y, box.x, box.height)).setTo(black);
+        output(cv::Rect(box.x + box.width, box.y,
+                        image.cols - box.x - box.width, box.height))
+                .setTo(black);
+
+        const uchar value = cv::saturate_cast<uchar>(threshold);
+        for (int row = box.y; row < box.y + box.height; row++) {
+            mask_kernel(image.ptr<uchar>(row) + 3 * box.x,
+                        mask.ptr<uchar>(row) + box.x,
+                        static_mask.empty() ? NULL :
+                        static_mask.ptr<uchar>(row) + box.x, value,
+                        output.ptr<uchar>(row) + 3 * box.x, box.width);
+        }
+    }
+}
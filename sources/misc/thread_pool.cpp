@@ -0,0 +1,146 @@
+#include "../../headers/misc/thread_pool.h"
+#include <algorithm>
+
+namespace tmd {
+    ThreadPool::ThreadPool(int thread_count) {
+        if (thread_count <= 0) {
+            thread_count = std::max(1u, std::thread::hardware_concurrency());
+        }
+        m_next_queue = 0;
+        m_pending_tasks = 0;
+        m_stop = false;
+        for (int i = 0; i < thread_count; i++) {
+            m_queues.push_back(new worker_queue_t);
+        }
+        for (int i = 0; i < thread_count; i++) {
+            m_workers.push_back(std::thread(&ThreadPool::run_worker,
+                                            std::ref(*this), i));
+        }
+        tmd::debug("ThreadPool", "ThreadPool", std::to_string(thread_count) +
+                                               " threads created");
+    }
+
+    ThreadPool::~ThreadPool() {
+        {
+            std::lock_guard<std::mutex> lock(m_sleep_lock);
+            m_stop = true;
+            m_wake_up.notify_all();
+        }
+        for (std::thread &worker : m_workers) {
+            worker.join();
+        }
+        for (worker_queue_t *queue : m_queues) {
+            delete queue;
+        }
+    }
+
+    void ThreadPool::run_all(const std::vector<task_t> &tasks) {
+        if (tasks.size() == 1) {
+            tasks[0]();
+            return;
+        }
+        if (tasks.empty()) {
+            return;
+        }
+
+        // Keeps track of the tasks of this call which are not done yet.
+        // The counter is only modified with the lock held so that the batch
+        // can not be destroyed while a thread is still notifying it.
+        std::mutex batch_lock;
+        std::condition_variable batch_done;
+        size_t remaining = tasks.size();
+
+        const int queue_count = static_cast<int>(m_queues.size());
+        for (const task_t &task : tasks) {
+            task_t wrapped = [&task, &batch_lock, &batch_done, &remaining]{
+                task();
+                std::lock_guard<std::mutex> lock(batch_lock);
+                remaining--;
+                if (remaining == 0) {
+                    batch_done.notify_all();
+                }
+            };
+            worker_queue_t *queue = m_queues[m_next_queue++ % queue_count];
+            std::lock_guard<std::mutex> lock(queue->lock);
+            queue->tasks.push_back(wrapped);
+        }
+        {
+            std::lock_guard<std::mutex> lock(m_sleep_lock);
+            m_pending_tasks += static_cast<int>(tasks.size());
+            m_wake_up.notify_all();
+        }
+
+        // Help the pool while the tasks are not done.
+        task_t task;
+        while (take_task(-1, task)) {
+            task();
+        }
+
+        // What is left is being executed by other threads.
+        std::unique_lock<std::mutex> lock(batch_lock);
+        batch_done.wait(lock, [&remaining]{ return remaining == 0; });
+    }
+
+    int ThreadPool::get_thread_count() {
+        return static_cast<int>(m_workers.size());
+    }
+
+    ThreadPool *ThreadPool::get_instance() {
+        static ThreadPool instance(tmd::Config::thread_pool_size);
+        return &instance;
+    }
+
+    void ThreadPool::run_worker(int worker_id) {
+        task_t task;
+        while (true) {
+            if (take_task(worker_id, task)) {
+                task();
+                continue;
+            }
+            std::unique_lock<std::mutex> lock(m_sleep_lock);
+            m_wake_up.wait(lock, [this]{
+                return m_stop || m_pending_tasks > 0;
+            });
+            if (m_stop) {
+                return;
+            }
+        }
+    }
+
+    bool ThreadPool::take_task(int worker_id, task_t &task) {
+        const int queue_count = static_cast<int>(m_queues.size());
+        bool found = false;
+
+        // Own queue first, from the front.
+        if (worker_id >= 0) {
+            worker_queue_t *queue = m_queues[worker_id];
+            std::lock_guard<std::mutex> lock(queue->lock);
+            if (!queue->tasks.empty()) {
+                task = queue->tasks.front();
+                queue->tasks.pop_front();
+                found = true;
+            }
+        }
+
+        // Then steal from the back of the other queues.
+        for (int i = 1; i <= queue_count && !found; i++) {
+            int victim = (std::max(worker_id, 0) + i) % queue_count;
+            if (victim == worker_id) {
+                continue;
+            }
+            worker_queue_t *queue = m_queues[victim];
+            std::lock_guard<std::mutex> lock(queue->lock);
+            if (!queue->tasks.empty()) {
+                task = queue->tasks.back();
+                queue->tasks.pop_back();
+                found = true;
+            }
+        }
+
+        if (found) {
+            std::lock_guard<std::mutex> lock(m_sleep_lock);
+            m_pending_tasks--;
+        }
+        return found;
+    }
+}
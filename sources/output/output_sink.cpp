@@ -0,0 +1,122 @@
+#include "../../headers/output/output_sink.h"
+#include <algorithm>
+
+namespace tmd {
+    OutputSink::OutputSink(const std::string &video_path, double fps,
+                           cv::Size size, const std::string &frame_prefix,
+                           bool show) {
+        const int queue_size = tmd::Config::output_queue_size;
+
+        m_writer = NULL;
+        m_video_frames = NULL;
+        if (!video_path.empty()) {
+            m_writer = new cv::VideoWriter(video_path,
+                                           CV_FOURCC('M', 'P', '4', 'V'), fps,
+                                           size, true);
+            m_video_frames = new tmd::BoundedQueue<cv::Mat>(queue_size);
+            m_video_worker = std::thread(&OutputSink::run_video_writer,
+                                         std::ref(*this));
+        }
+
+        m_frame_prefix = frame_prefix;
+        m_jpeg_frames = NULL;
+        if (!frame_prefix.empty()) {
+            m_jpeg_frames = new tmd::BoundedQueue<std::pair<int, cv::Mat>>(
+                    queue_size);
+            for (int i = 0; i < std::max(1, tmd::Config::output_jpeg_threads);
+                 i++) {
+                m_jpeg_workers.push_back(std::thread(
+                        &OutputSink::run_jpeg_encoder, std::ref(*this)));
+            }
+        }
+
+        m_show = show;
+        m_display_closed = false;
+        if (show) {
+            m_display_worker = std::thread(&OutputSink::run_display,
+                                           std::ref(*this));
+        }
+    }
+
+    OutputSink::~OutputSink() {
+        // The queues are closed, not cleared : the threads stop once they
+        // have emptied them.
+        if (m_writer != NULL) {
+            m_video_frames->close();
+            m_video_worker.join();
+            delete m_video_frames;
+            delete m_writer;
+        }
+        if (m_jpeg_frames != NULL) {
+            m_jpeg_frames->close();
+            for (std::thread &worker : m_jpeg_workers) {
+                worker.join();
+            }
+            delete m_jpeg_frames;
+        }
+        if (m_show) {
+            {
+                std::lock_guard<std::mutex> lock(m_display_lock);
+                m_display_closed = true;
+                m_display_ready.notify_one();
+            }
+            m_display_worker.join();
+        }
+    }
+
+    void OutputSink::write(const cv::Mat &result, int frame_index) {
+        if (m_writer != NULL) {
+            m_video_frames->push(result);
+        }
+        if (m_jpeg_frames != NULL) {
+            m_jpeg_frames->push(std::make_pair(frame_index, result));
+        }
+        if (m_show) {
+            std::lock_guard<std::mutex> lock(m_display_lock);
+            if (!m_display_frame.empty()) {
+                tmd::debug("OutputSink", "write", "Display behind, frame "
+                        "dropped.");
+            }
+            m_display_frame = result;
+            m_display_ready.notify_one();
+        }
+    }
+
+    void OutputSink::run_video_writer() {
+        cv::Mat frame;
+        while (m_video_frames->pop(frame)) {
+            m_writer->write(frame);
+        }
+    }
+
+    void OutputSink::run_jpeg_encoder() {
+        std::pair<int, cv::Mat> entry;
+        while (m_jpeg_frames->pop(entry)) {
+            std::string file_name = m_frame_prefix +
+                                    std::to_string(entry.first) + ".jpg";
+            cv::imwrite(file_name, entry.second);
+        }
+    }
+
+    void OutputSink::run_display() {
+        // The window belongs to this thread.
+        SDL_Window *window = tmd::SDLBinds::create_sdl_window("TMD");
+        while (true) {
+            cv::Mat frame;
+            {
+                std::unique_lock<std::mutex> lock(m_display_lock);
+                m_display_ready.wait(lock, [this] {
+                    return m_display_closed || !m_display_frame.empty();
+                });
+                if (m_display_frame.empty()) {
+                    break; // Closed and nothing left to show.
+                }
+                frame = m_display_frame;
+                m_display_frame.release();
+            }
+            tmd::SDLBinds::imshow(window, frame);
+        }
+        tmd::SDLBinds::destroy_sdl_window(window);
+        tmd::SDLBinds::quit_sdl();
+    }
+}
@@ -4,52 +4,129 @@
 namespace tmd{
     ApproximativePipeline::ApproximativePipeline(const std::string &video_folder
             ,int camera_index, int thread_count, int start_frame, int end_frame,
-             int box_step) : Pipeline(video_folder, camera_index, start_frame,
+             int box_step, bool adaptive) : Pipeline(video_folder, camera_index, start_frame,
                                       end_frame, 1){
 
-        m_video->set(CV_CAP_PROP_POS_FRAMES, start_frame);
-        m_last_frame_computed = NULL;
+        m_source = tmd::FrameSource::open(video_folder, camera_index);
+        if (!m_source->seek(start_frame)) {
+            delete m_source;
+            throw std::invalid_argument("Error couldn't reach the starting "
+                                                "frame in the pipeline.");
+        }
+        if (tmd::Config::frame_source_prefetch_size > 0) {
+            m_source = new tmd::PrefetchFrameSource(m_source, 1,
+                                    tmd::Config::frame_source_prefetch_size);
+        }
+        m_last_frame_computed = new tmd::frame_t; // No box yet.
         m_frame_pos = start_frame;
         m_box_step = box_step;
 
-        double fps = m_video->get(CV_CAP_PROP_FPS);
-        m_frame_delay = 1.0 / fps;
+        m_fps = m_source->get_fps();
+        m_frame_delay = 1.0 / m_fps;
+        m_last_frame_time = cv::getTickCount();
 
         m_pipeline = new tmd::MultithreadedPipeline(video_folder, camera_index,
                                                     thread_count, start_frame,
                                                     end_frame, m_box_step);
+        m_controller = NULL;
+        if (adaptive) {
+            m_controller = new tmd::RealTimeController(m_fps, m_box_step,
+                                                       thread_count);
+        }
+
+        m_pending_frame = NULL;
+        m_display_pos = start_frame - 1;
+        m_stop_request = false;
+        m_refresher = std::thread(&ApproximativePipeline::refresh_boxes,
+                                  std::ref(*this));
     }
 
     ApproximativePipeline::~ApproximativePipeline(){
+        {
+            std::lock_guard<std::mutex> lock(m_display_lock);
+            m_stop_request = true;
+            m_display_moved.notify_all();
+        }
+        m_pipeline->stop(); // Wakes up the refresher if it waits for boxes.
+        m_refresher.join();
         delete m_pipeline;
+        delete m_controller;
+        free_frame(m_pending_frame.exchange(NULL));
         free_frame(m_last_frame_computed);
+        delete m_source;
     }
 
     frame_t* ApproximativePipeline::next_frame() {
         cv::Mat video_frame;
-        if (!m_video->read(video_frame)) {
+        if (m_frame_pos > m_end || !m_source->read(video_frame)) {
             return NULL;
         }
-        if ((m_frame_pos - m_start) % m_box_step == 0) {
+
+        tmd::frame_t *new_boxes = m_pending_frame.exchange(NULL);
+        if (new_boxes != NULL) {
             free_frame(m_last_frame_computed);
-            m_last_frame_computed = m_pipeline->next_frame();
-            if (m_last_frame_computed == NULL) {
-                return NULL;
-            }
+            m_last_frame_computed = new_boxes;
         }
 
         m_last_frame_computed->original_frame = video_frame;
-        m_last_frame_computed->frame_index ++;
+        m_last_frame_computed->frame_index = m_frame_pos;
+        {
+            std::lock_guard<std::mutex> lock(m_display_lock);
+            m_display_pos = m_frame_pos;
+            m_display_moved.notify_all();
+        }
         m_frame_pos += m_step;
 
         if (tmd::Config::show_results) {
             // We need to wait to output at the same frame rate as the video.
-            while ((cv::getTickCount() - m_last_frame_time) /
-                           cv::getTickFrequency() < m_frame_delay);
+            double elapsed = (cv::getTickCount() - m_last_frame_time) /
+                             cv::getTickFrequency();
+            if (elapsed < m_frame_delay) {
+                std::this_thread::sleep_for(std::chrono::duration<double>(
+                        m_frame_delay - elapsed));
+            }
         }
 
         m_last_frame_time = cv::getTickCount();
 
         return m_last_frame_computed;
     }
+
+    void ApproximativePipeline::refresh_boxes() {
+        while (!m_stop_request) {
+            tmd::frame_t *frame = m_pipeline->next_frame();
+            if (frame == NULL) {
+                return;
+            }
+
+            if (m_controller != NULL) {
+                double lag = (m_display_pos - frame->frame_index) / m_fps;
+                double processing_time = m_pipeline->get_mean_processing_time();
+                if (m_controller->add_measure(processing_time, lag)) {
+                    m_box_step = m_controller->get_box_step();
+                    m_pipeline->set_step_size(m_box_step);
+                }
+            }
+
+            // Boxes computed ahead of the display would be drawn on earlier
+            // frames, so they wait until the display catches up.
+            {
+                std::unique_lock<std::mutex> lock(m_display_lock);
+                m_display_moved.wait(lock, [this, frame] {
+                    return m_stop_request ||
+                           m_display_pos >= frame->frame_index;
+                });
+            }
+            if (m_stop_request) {
+                free_frame(frame);
+                return;
+            }
+
+            tmd::debug("ApproximativePipeline", "refresh_boxes", "Boxes of "
+                    "frame " + std::to_string(frame->frame_index) + " ready");
+            // If the display has not taken the previous boxes yet, they are
+            // already outdated.
+            free_frame(m_pending_frame.exchange(frame));
+        }
+    }
 }
@@ -0,0 +1,66 @@
+#include "../../headers/pipelines/detection_stage.h"
+
+namespace tmd {
+    DetectionStage::DetectionStage()
+            : DetectionStage(AssetRegistry::get_instance()->get_centers()) {
+    }
+
+    DetectionStage::DetectionStage(const cv::Mat &centers) {
+        if (tmd::Config::use_dpm_player_extractor){
+            m_playerExtractor = new DPMPlayerExtractor();
+        }
+        else {
+            m_playerExtractor = new BlobPlayerExtractor();
+        }
+
+        m_featuresComparator = new FeatureComparator
+                (tmd::Config::features_comparator_center_count,
+                 tmd::Config::features_comparator_sample_cols, centers);
+        m_featuresExtractor = new FeaturesExtractor();
+    }
+
+    DetectionStage::~DetectionStage() {
+        delete m_playerExtractor;
+        delete m_featuresExtractor;
+        delete m_featuresComparator;
+    }
+
+    void DetectionStage::process_frame(tmd::frame_t *frame) {
+        if (!tmd::Config::use_bgs){
+            const int rows = frame->original_frame.rows;
+            const int cols = frame->original_frame.cols;
+            frame->mask_frame = cv::Mat::ones(rows, cols, CV_8U);
+            frame->colored_mask_frame = frame->original_frame;
+            // The extractor reads the mask and the blobs of the BGS first :
+            // it has to use this mask, on the whole frame.
+            frame->packed_mask = tmd::PackedMask();
+            frame->mask_blobs.clear();
+            frame->mask_blobs_radius = -1;
+            frame->mask_roi = cv::Rect();
+            cv::Rect blob = cv::Rect(0, 0, rows, cols);
+            frame->blobs.clear();
+            frame->blobs.push_back(blob);
+        }
+
+        tmd::debug("DetectionStage", "process_frame", "Extracting players.");
+        std::vector<tmd::player_t *> players =
+                m_playerExtractor->extract_player_from_frame(frame);
+
+        tmd::debug("DetectionStage", "process_frame",
+                   std::to_string(players.size()) + " players/blobs extracted.");
+
+        if (!tmd::Config::use_dpm_player_extractor && tmd::Config::use_bgs){
+            tmd::debug("DetectionStage", "process_frame", "Separate blobs.");
+            players = BlobSeparator::separate_blobs(players);
+            tmd::debug("DetectionStage", "process_frame", "Done");
+        }
+
+        tmd::debug("DetectionStage", "process_frame", "Frame " +
+                   std::to_string(frame->frame_index) + " : " +
+                   std::to_string(players.size()) + " players detected");
+        m_featuresExtractor->extractFeaturesFromPlayers(players);
+        m_featuresComparator->detectTeamForPlayers(players);
+        frame->players = players;
+        tmd::release_intermediate_images(frame);
+    }
+}
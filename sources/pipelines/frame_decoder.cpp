@@ -0,0 +1,191 @@
+#include "../../headers/pipelines/frame_decoder.h"
+#include <limits>
+
+namespace tmd {
+    FrameDecoder::FrameDecoder(std::string video_folder, int camera_index,
+                               int start_frame, int end_frame, int step_size,
+                               int output_count, bool update_frames,
+                               int update_output_count) {
+        if (output_count <= 0) {
+            throw std::invalid_argument("Error : In FrameDecoder : "
+                                                "negative output count");
+        }
+        // No prefetching source here, this thread already decodes ahead.
+        m_source = tmd::FrameSource::open(video_folder, camera_index);
+
+        // The background models are initialized with the first frame of
+        // the video, whatever the starting frame is.
+        m_first_frame = m_source->get_first_frame();
+        if (!m_source->seek(start_frame)) {
+            delete m_source;
+            throw std::invalid_argument("Error couldn't reach the starting "
+                                                "frame in the frame decoder.");
+        }
+
+        m_camera_index = camera_index;
+        m_start = start_frame;
+        m_end = end_frame;
+        m_step = step_size;
+        m_update_frames = update_frames &&
+                          tmd::Config::bgs_update_interval > 0;
+
+        for (int i = 0; i < output_count; i++) {
+            m_outputs.push_back(new tmd::BoundedQueue<tmd::frame_t *>(
+                    tmd::Config::pipeline_buffer_size));
+        }
+        // Not bounded : a thread can't fall more than the capacity of the
+        // ReorderBuffer behind the others, which bounds its update frames.
+        // Waiting for it here could block the threads it waits for.
+        for (int i = 0; m_update_frames && i < update_output_count; i++) {
+            m_update_outputs.push_back(new tmd::BoundedQueue<tmd::frame_t *>(
+                    std::numeric_limits<size_t>::max()));
+        }
+
+        m_stop_request = false;
+        m_frame_count = 0;
+        m_worker = std::thread(&FrameDecoder::decode, std::ref(*this));
+    }
+
+    FrameDecoder::~FrameDecoder() {
+        stop();
+        m_worker.join();
+        for (tmd::BoundedQueue<tmd::frame_t *> *output : m_outputs) {
+            tmd::frame_t *frame;
+            while (output->pop(frame)) {
+                free_frame(frame);
+            }
+            delete output;
+        }
+        for (tmd::BoundedQueue<tmd::frame_t *> *output : m_update_outputs) {
+            tmd::frame_t *frame;
+            while (output->pop(frame)) {
+                free_frame(frame);
+            }
+            delete output;
+        }
+        delete m_source;
+    }
+
+    tmd::BoundedQueue<tmd::frame_t *> *FrameDecoder::get_output(int index) {
+        return m_outputs[index];
+    }
+
+    tmd::BoundedQueue<tmd::frame_t *> *FrameDecoder::get_update_output(
+            int index) {
+        if (m_update_outputs.empty()) {
+            return NULL;
+        }
+        return m_update_outputs[index];
+    }
+
+    cv::Mat FrameDecoder::get_first_frame() {
+        return m_first_frame;
+    }
+
+    long FrameDecoder::get_frame_count() {
+        return m_frame_count;
+    }
+
+    void FrameDecoder::set_step_size(int step_size) {
+        if (step_size > 0) {
+            m_step = step_size;
+        }
+    }
+
+    void FrameDecoder::stop() {
+        m_stop_request = true;
+        for (tmd::BoundedQueue<tmd::frame_t *> *output : m_outputs) {
+            output->close();
+        }
+        for (tmd::BoundedQueue<tmd::frame_t *> *output : m_update_outputs) {
+            output->close();
+        }
+    }
+
+    bool FrameDecoder::skip_frame(int frame_index) {
+        if (!m_update_frames || frame_index > m_end ||
+            frame_index % tmd::Config::bgs_update_interval != 0) {
+            m_source->skip();
+            return true;
+        }
+        cv::Mat image;
+        if (!m_source->read(image)) {
+            return true;
+        }
+        return push_update(image, frame_index);
+    }
+
+    bool FrameDecoder::push_update(const cv::Mat &image, int frame_index) {
+        std::vector<tmd::BoundedQueue<tmd::frame_t *> *> &outputs =
+                m_update_outputs.empty() ? m_outputs : m_update_outputs;
+        for (tmd::BoundedQueue<tmd::frame_t *> *output : outputs) {
+            tmd::frame_t *frame = new tmd::frame_t;
+            // The models don't write in the frames, they can share them.
+            frame->original_frame = image;
+            frame->frame_index = frame_index;
+            frame->camera_index = m_camera_index;
+            frame->sequence_index = -1;
+            frame->update_only = true;
+            if (!output->push(frame)) {
+                free_frame(frame);
+                return false;
+            }
+        }
+        return true;
+    }
+
+    void FrameDecoder::decode() {
+        const int output_count = static_cast<int>(m_outputs.size());
+        int next_output = 0;
+        int frame_index = m_start;
+
+        while (!m_stop_request && frame_index <= m_end) {
+            tmd::frame_t *frame = new tmd::frame_t;
+            if (!m_source->read(frame->original_frame)) {
+                delete frame;
+                break;
+            }
+            frame->frame_index = frame_index;
+            frame->camera_index = m_camera_index;
+            frame->sequence_index = static_cast<int>(m_frame_count);
+
+            tmd::debug("FrameDecoder", "decode", "Frame " +
+                       std::to_string(frame_index) + " sent to output " +
+                       std::to_string(next_output));
+            m_frame_count++;
+            // The threads sharing the output which don't get this frame
+            // still give it to their models. Its own thread may draw on it.
+            if (!m_update_outputs.empty() &&
+                frame_index % tmd::Config::bgs_update_interval == 0 &&
+                !push_update(frame->original_frame.clone(), frame_index)) {
+                free_frame(frame);
+                break;
+            }
+            if (!m_outputs[next_output]->push(frame)) {
+                free_frame(frame);
+                break;
+            }
+            next_output = (next_output + 1) % output_count;
+
+            // The skipped frames are only decoded if they update the
+            // models.
+            const int step = m_step;
+            bool open = true;
+            for (int i = 1; i < step && open; i++) {
+                open = skip_frame(frame_index + i);
+            }
+            if (!open) {
+                break;
+            }
+            frame_index += step;
+        }
+
+        for (tmd::BoundedQueue<tmd::frame_t *> *output : m_outputs) {
+            output->push(NULL); // Indicating the end.
+            output->close();
+        }
+        for (tmd::BoundedQueue<tmd::frame_t *> *output : m_update_outputs) {
+            output->close();
+        }
+    }
+}
@@ -0,0 +1,108 @@
+#include "../../headers/pipelines/multi_camera_pipeline.h"
+
+namespace tmd {
+    MultiCameraPipeline::MultiCameraPipeline(std::string video_folder,
+                                             std::vector<int> camera_indices,
+                                             int start_frame, int end_frame,
+                                             int step_size) {
+        if (camera_indices.empty()) {
+            throw std::invalid_argument("Error : In multi camera pipeline : "
+                                                "no camera given");
+        }
+
+        const cv::Mat centers = AssetRegistry::get_instance()->get_centers();
+
+        m_stop_request = false;
+        m_done = false;
+        for (int camera_index : camera_indices) {
+            camera_t *camera = new camera_t;
+            camera->camera_index = camera_index;
+            camera->decoder = new FrameDecoder(video_folder, camera_index,
+                                               start_frame, end_frame,
+                                               step_size, 1, true);
+            camera->bgSubstractor = new BGSubstractor(
+                    camera->decoder->get_first_frame(), camera_index);
+            camera->bgSubstractor->catch_up(video_folder, start_frame);
+            camera->detectionStage = new DetectionStage(centers);
+            camera->output = new BoundedQueue<frame_t *>(
+                    tmd::Config::multi_camera_max_skew);
+            m_cameras.push_back(camera);
+        }
+        for (camera_t *camera : m_cameras) {
+            camera->worker = std::thread(&MultiCameraPipeline::run_camera,
+                                         std::ref(*this), camera);
+        }
+    }
+
+    MultiCameraPipeline::~MultiCameraPipeline() {
+        m_stop_request = true;
+        for (camera_t *camera : m_cameras) {
+            camera->decoder->stop();
+            camera->output->close();
+        }
+        for (camera_t *camera : m_cameras) {
+            camera->worker.join();
+
+            frame_t *frame;
+            while (camera->output->pop(frame)) {
+                free_frame(frame);
+            }
+            delete camera->output;
+            delete camera->detectionStage;
+            delete camera->bgSubstractor;
+            delete camera->decoder;
+            delete camera;
+        }
+    }
+
+    std::vector<tmd::frame_t *> MultiCameraPipeline::next_frames() {
+        std::vector<frame_t *> frames;
+        if (m_done) {
+            return frames;
+        }
+        for (camera_t *camera : m_cameras) {
+            frame_t *frame = NULL;
+            if (!camera->output->pop(frame) || frame == NULL) {
+                m_done = true;
+                break;
+            }
+            frames.push_back(frame);
+        }
+        if (m_done) {
+            for (frame_t *frame : frames) {
+                free_frame(frame);
+            }
+            frames.clear();
+        }
+        return frames;
+    }
+
+    std::vector<int> MultiCameraPipeline::get_camera_indices() {
+        std::vector<int> camera_indices;
+        for (camera_t *camera : m_cameras) {
+            camera_indices.push_back(camera->camera_index);
+        }
+        return camera_indices;
+    }
+
+    void MultiCameraPipeline::run_camera(camera_t *camera) {
+        tmd::BoundedQueue<frame_t *> *input = camera->decoder->get_output(0);
+        frame_t *frame;
+        while (!m_stop_request && input->pop(frame) && frame != NULL) {
+            camera->bgSubstractor->process_frame(frame);
+            if (frame->update_only) {
+                free_frame(frame);
+                continue;
+            }
+            camera->detectionStage->process_frame(frame);
+            tmd::debug("MultiCameraPipeline", "run_camera", "Camera " +
+                       std::to_string(camera->camera_index) + " : frame " +
+                       std::to_string(frame->frame_index) + " done");
+            if (!camera->output->push(frame)) {
+                free_frame(frame);
+                return;
+            }
+        }
+        camera->output->push(NULL); // Indicating the end.
+    }
+}
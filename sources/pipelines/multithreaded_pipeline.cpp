@@ -6,63 +6,86 @@ namespace tmd {
              int step_size) : Pipeline(video_folder, camera_index, start_frame,
              end_frame, step_size) {
 
-        m_frame_pos = m_start;
         m_thread_count = thread_count;
         if (m_thread_count <= 0) {
             throw std::invalid_argument("Error : In nultithreaded pipeline : "
                                                 "negative thread count");
         }
-        m_next_thread_to_use = 0;
+        m_done = false;
+        m_results = new tmd::ReorderBuffer<tmd::frame_t *>(
+                tmd::Config::pipeline_buffer_size * m_thread_count);
         m_pipeline_threads = new tmd::PipelineThread *[m_thread_count];
 
         schedule_threads(video_folder);
     }
 
     MultithreadedPipeline::~MultithreadedPipeline() {
+        // Wake up the threads waiting for a frame or for room in the
+        // results before stopping them.
+        stop();
         for (int i = 0; i < m_thread_count; i++) {
             delete m_pipeline_threads[i];
         }
         delete[] m_pipeline_threads;
+        delete m_decoder;
+        delete m_results;
     }
 
     frame_t *MultithreadedPipeline::next_frame() {
-        int thread_id = m_next_thread_to_use;
-        tmd::frame_t *frame = m_pipeline_threads[thread_id]->pop_buffer();
-        m_frame_pos += m_step;
-        m_next_thread_to_use = (m_next_thread_to_use + 1) % m_thread_count;
+        if (m_done) {
+            return NULL;
+        }
+        tmd::frame_t *frame = NULL;
+        if (!m_results->pop(frame)) {
+            frame = NULL;
+        }
+        m_done = (frame == NULL);
         return frame;
     }
 
+    void MultithreadedPipeline::stop() {
+        m_decoder->stop();
+        std::vector<tmd::frame_t *> remaining;
+        m_results->close(remaining);
+        for (tmd::frame_t *frame : remaining) {
+            free_frame(frame);
+        }
+    }
+
+    void MultithreadedPipeline::set_step_size(int step_size) {
+        m_step = step_size;
+        m_decoder->set_step_size(step_size);
+    }
+
+    double MultithreadedPipeline::get_mean_processing_time() {
+        double total_time = 0;
+        int total_count = 0;
+        for (int i = 0; i < m_thread_count; i++) {
+            double busy_time;
+            int frame_count;
+            m_pipeline_threads[i]->take_processing_stats(busy_time,
+                                                         frame_count);
+            total_time += busy_time;
+            total_count += frame_count;
+        }
+        return total_count > 0 ? total_time / total_count : 0;
+    }
+
     void MultithreadedPipeline::schedule_threads(std::string video_folder) {
         tmd::debug("MultithreadedPipeline", "create_threads", "Creating "
                 "threads");
-        m_end = m_end - (m_end % m_step);
-        int mod = (m_end / m_thread_count) % m_thread_count;
+        m_decoder = new tmd::FrameDecoder(video_folder, m_camera_index,
+                                          m_start, m_end, m_step, 1, true,
+                                          m_thread_count);
 
         for (int i = 0; i < m_thread_count; i++) {
-            int threadId = i;
-            int starting_frame = m_start + threadId * m_step;
-            int ending_frame;
-            if (threadId <= mod) {
-                ending_frame = m_end - (mod - threadId) * m_step;
-            }
-            else {
-                ending_frame = m_end - (mod - threadId) * m_step -
-                               m_thread_count * m_step;
-            }
-            int step = m_step * m_thread_count;
-
             tmd::debug("MultithreadedPipeline", "create_threads", "Creating "
-                          "thread " + std::to_string(i) +
-                          " starting_frame = " +
-                          std::to_string(starting_frame) + " ending_frame = " +
-                          std::to_string(ending_frame) + " step = " +
-                          std::to_string(step));
+                          "thread " + std::to_string(i));
 
             m_pipeline_threads[i] = new PipelineThread(video_folder,
-                                                       m_camera_index, threadId,
-                                                       starting_frame,
-                                                       ending_frame, step);
+                                                       m_camera_index, i,
+                                                       m_start, m_end, m_step,
+                                                       m_decoder, m_results);
         }
     }
 }
\ No newline at end of file
@@ -3,72 +3,62 @@
 namespace tmd {
     PipelineThread::PipelineThread(std::string video_folder, int camera_index,
                                    int thread_id, int starting_frame,
-                                   int ending_frame, int step_size) {
+                                   int ending_frame, int step_size,
+                                   tmd::FrameDecoder *decoder,
+                                   tmd::ReorderBuffer<tmd::frame_t *> *output) {
         m_id = thread_id;
         m_step_size = step_size;
         m_starting_frame = starting_frame;
-        m_frame_idx = m_starting_frame;
         m_ending_frame = ending_frame;
+        m_decoder = decoder;
+        m_output = output;
         m_pipeline = new tmd::SimplePipeline(video_folder, camera_index,
-                                     starting_frame, ending_frame, step_size);
+                                     starting_frame, ending_frame, step_size,
+                                     decoder, 0, thread_id);
         m_stop_request = false;
+        m_busy_ticks = 0;
+        m_frames_done = 0;
 
-        m_done = false;
         m_worker = std::thread(&PipelineThread::extract_from_pipeline,
                                std::ref(*this));
     }
 
     PipelineThread::~PipelineThread() {
-        if (!m_done) {
-            m_stop_request = true;
-            while (!m_worker_stopped) {
-                tmd::debug("PipelineThread", "~PipelineThread", "Waiting for "
-                        "thread to stop.");
-            }
-        }
+        m_stop_request = true;
+        m_worker.join();
         delete m_pipeline;
     }
 
-    tmd::frame_t *PipelineThread::pop_buffer() {
-        if (m_done){
-            return NULL;
-        }
-        tmd::frame_t *head = NULL;
-        while (true) {
-            {
-                std::lock_guard<std::mutex> lock(m_buffer_lock);
-                if (m_buffer.size() > 0) {
-                    head = m_buffer[0];
-                    m_buffer.pop_front();
-                    m_done = (head == NULL);
-                    return head;
-                }
-            }
-        }
+    void PipelineThread::take_processing_stats(double &busy_time,
+                                               int &frame_count) {
+        busy_time = m_busy_ticks.exchange(0) / cv::getTickFrequency();
+        frame_count = m_frames_done.exchange(0);
     }
 
     void PipelineThread::extract_from_pipeline() {
-        while (!m_stop_request && m_frame_idx <= m_ending_frame) {
+        // The decoder takes care of the frame range, and closes its output
+        // when there is no frame left.
+        while (!m_stop_request) {
             tmd::debug("PipelineThread", "extract_from_pipeline", "Thread " +
                               std::to_string(m_id) + " calling next_players()");
-            tmd::frame_t *next_buffer_entry = m_pipeline->next_frame();
-            if (next_buffer_entry == NULL) {
+            tmd::frame_t *frame = m_pipeline->next_frame();
+            // Without the time spent waiting for the decoder.
+            m_busy_ticks += m_pipeline->take_compute_ticks();
+            if (frame == NULL) {
                 break;
             }
+            m_frames_done++;
+            long sequence = frame->sequence_index;
             tmd::debug("PipelineThread", "extract_from_pipeline", "Thread " +
-                                              std::to_string(m_id) + " : Done");
-            this->push_buffer(next_buffer_entry);
-            m_frame_idx += m_step_size;
+                              std::to_string(m_id) + " : Done with sequence " +
+                              std::to_string(sequence));
+            if (!m_output->push(sequence, frame)) {
+                free_frame(frame);
+                return;
+            }
         }
-        this->push_buffer(NULL); // Indicating the end.
-        std::lock_guard<std::mutex> lock(m_buffer_lock);
-        m_worker_stopped = true;
-    }
-
-    void PipelineThread::push_buffer(tmd::frame_t *frame) {
-        std::lock_guard<std::mutex> lock(m_buffer_lock);
-        tmd::debug("PipelineThread", "push_buffer", "Thread " +
-                                std::to_string(m_id) + " push entry in buffer");
-        m_buffer.push_back(frame);
+        // Every thread pushes the end marker after the last decoded frame,
+        // only the first one is popped.
+        m_output->push(m_decoder->get_frame_count(), NULL);
     }
-}
\ No newline at end of file
+}
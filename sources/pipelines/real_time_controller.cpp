@@ -0,0 +1,123 @@
+#include <iostream>
+#include <algorithm>
+#include <limits>
+#include <stdexcept>
+#include <thread>
+#include "../../headers/pipelines/real_time_controller.h"
+
+namespace tmd {
+    RealTimeController::RealTimeController(double fps, int box_step,
+                                           int thread_count) {
+        if (fps <= 0 || box_step <= 0 || thread_count <= 0) {
+            throw std::invalid_argument("Error : In RealTimeController : "
+                                                "invalid parameters");
+        }
+        m_fps = fps;
+        m_thread_count = thread_count;
+
+        m_box_step = box_step;
+        m_min_box_step = box_step;
+        m_min_blob_size = tmd::BlobPlayerExtractor::get_min_blob_size();
+        m_blob_size = m_min_blob_size;
+        m_min_dpm_threads = tmd::DPM::get_thread_count();
+        m_dpm_threads = m_min_dpm_threads;
+
+        m_measure_count = 0;
+        m_processing_sum = 0;
+        m_lag_sum = 0;
+        m_last_lag = 0;
+        m_last_processing_time = 0;
+    }
+
+    bool RealTimeController::add_measure(double processing_time, double lag) {
+        m_processing_sum += processing_time;
+        m_lag_sum += std::max(lag, 0.0);
+        m_measure_count++;
+        if (m_measure_count < tmd::Config::controller_window) {
+            return false;
+        }
+
+        m_last_processing_time = m_processing_sum / m_measure_count;
+        m_last_lag = m_lag_sum / m_measure_count;
+        m_measure_count = 0;
+        m_processing_sum = 0;
+        m_lag_sum = 0;
+
+        const double target = tmd::Config::controller_target_latency;
+        if (m_last_lag > target || load_for_step(m_box_step) > 1.0) {
+            if (m_blob_size < tmd::Config::controller_max_blob_size) {
+                int new_size = std::min(m_blob_size + m_blob_size / 4 + 1,
+                                        tmd::Config::controller_max_blob_size);
+                log("blob_player_extractor_min_blob_size", m_blob_size,
+                    new_size);
+                m_blob_size = new_size;
+                tmd::BlobPlayerExtractor::set_min_blob_size(m_blob_size);
+            }
+            else if (m_box_step < tmd::Config::controller_max_box_step) {
+                log("box_step", m_box_step, m_box_step + 1);
+                m_box_step++;
+                return true;
+            }
+            else if (m_dpm_threads < get_max_dpm_threads()) {
+                log("dpm_detector_numthread", m_dpm_threads,
+                    m_dpm_threads + 1);
+                m_dpm_threads++;
+                tmd::DPM::set_thread_count(m_dpm_threads);
+            }
+        }
+        else if (m_last_lag < target / 2) {
+            // Only give back what should still fit afterwards.
+            if (m_dpm_threads > m_min_dpm_threads &&
+                load_for_step(m_box_step) < 0.8) {
+                log("dpm_detector_numthread", m_dpm_threads,
+                    m_dpm_threads - 1);
+                m_dpm_threads--;
+                tmd::DPM::set_thread_count(m_dpm_threads);
+            }
+            else if (m_box_step > m_min_box_step &&
+                     load_for_step(m_box_step - 1) < 0.8) {
+                log("box_step", m_box_step, m_box_step - 1);
+                m_box_step--;
+                return true;
+            }
+            else if (m_blob_size > m_min_blob_size &&
+                     load_for_step(m_box_step) < 0.8) {
+                int new_size = std::max(m_blob_size - m_blob_size / 5,
+                                        m_min_blob_size);
+                log("blob_player_extractor_min_blob_size", m_blob_size,
+                    new_size);
+                m_blob_size = new_size;
+                tmd::BlobPlayerExtractor::set_min_blob_size(m_blob_size);
+            }
+        }
+        return false;
+    }
+
+    int RealTimeController::get_box_step() {
+        return m_box_step;
+    }
+
+    int RealTimeController::get_max_dpm_threads() {
+        int max_threads = tmd::Config::controller_max_dpm_threads;
+        if (max_threads <= 0) {
+            max_threads = std::max(1u, std::thread::hardware_concurrency());
+        }
+        return std::max(max_threads, m_min_dpm_threads);
+    }
+
+    double RealTimeController::load_for_step(int box_step) {
+        if (box_step <= 0) {
+            return std::numeric_limits<double>::max();
+        }
+        double available_time = box_step * m_thread_count / m_fps;
+        return m_last_processing_time / available_time;
+    }
+
+    void RealTimeController::log(const std::string &setting, int old_value,
+                                 int new_value) {
+        std::cout << "Controller : " << setting << " " << old_value << " -> "
+        << new_value << " (lag = " << m_last_lag << "s, frame time = " <<
+        m_last_processing_time << "s, load = " << load_for_step(m_box_step)
+        << ")" << std::endl;
+    }
+}
@@ -0,0 +1,209 @@
+#include "../../headers/pipelines/shard_coordinator.h"
+#include "../../headers/frame_sources/frame_source.h"
+#include <cstdio>
+#include <climits>
+#include <fcntl.h>
+#include <fstream>
+#include <unistd.h>
+#include <sys/wait.h>
+
+namespace tmd {
+    ShardCoordinator::ShardCoordinator(const std::string &program,
+                                       const std::string &video_folder,
+                                       int camera_index, int start_frame,
+                                       int end_frame, int step_size,
+                                       int shard_count) {
+        if (shard_count <= 0 || step_size <= 0) {
+            throw std::invalid_argument("Error : In ShardCoordinator : "
+                                                "invalid shard count or step");
+        }
+        m_program = program;
+        // argv[0] is not a path if the program was started through PATH.
+        char executable[PATH_MAX];
+        const ssize_t length = readlink("/proc/self/exe", executable,
+                                        sizeof(executable) - 1);
+        if (length > 0) {
+            executable[length] = '\0';
+            m_executable = executable;
+        }
+        else {
+            m_executable = "";
+        }
+        m_video_folder = video_folder;
+        m_camera_index = camera_index;
+        m_step_size = step_size;
+
+        tmd::FrameSource *source = tmd::FrameSource::open(video_folder,
+                                                          camera_index);
+        const int frame_count = source->get_frame_count();
+        delete source;
+        if (frame_count >= 0 && end_frame >= frame_count) {
+            end_frame = frame_count - 1;
+        }
+        else if (frame_count < 0 &&
+                 end_frame == std::numeric_limits<int>::max()) {
+            throw std::invalid_argument("Error : In ShardCoordinator : the "
+                    "length of the video is unknown, an ending frame is "
+                    "needed");
+        }
+        if (end_frame < start_frame) {
+            return;
+        }
+
+        // The chunks start on the frames the whole range would compute, so
+        // that the merged results are the same as with a single process.
+        const int total = (end_frame - start_frame) / step_size + 1;
+        for (int i = 0; i < shard_count; i++) {
+            const int first = static_cast<int>((long) total * i / shard_count);
+            const int last = static_cast<int>(
+                    (long) total * (i + 1) / shard_count) - 1;
+            if (last < first) {
+                continue;
+            }
+            shard_t shard;
+            shard.start_frame = start_frame + first * step_size;
+            shard.end_frame = start_frame + last * step_size;
+            shard.output = "shard_" + std::to_string(i);
+            shard.pid = -1;
+            m_shards.push_back(shard);
+        }
+    }
+
+    bool ShardCoordinator::run(const std::string &log_path,
+                               const std::string &video_path) {
+        bool success = true;
+        for (shard_t &shard : m_shards) {
+            if (!start_shard(shard)) {
+                success = false;
+            }
+        }
+
+        for (shard_t &shard : m_shards) {
+            if (shard.pid < 0) {
+                continue;
+            }
+            int status;
+            if (waitpid(shard.pid, &status, 0) < 0 || !WIFEXITED(status) ||
+                WEXITSTATUS(status) != EXIT_SUCCESS) {
+                std::cout << "Error, the shard of the frames " <<
+                shard.start_frame << " to " << shard.end_frame <<
+                " failed, see " << shard.output << ".out" << std::endl;
+                success = false;
+            }
+            else {
+                tmd::debug("ShardCoordinator", "run", "Shard " +
+                           shard.output + " done.");
+            }
+        }
+        if (!success) {
+            return false;
+        }
+
+        if (!log_path.empty() && !merge_logs(log_path)) {
+            return false;
+        }
+        if (!video_path.empty() && !merge_videos(video_path)) {
+            return false;
+        }
+        for (shard_t &shard : m_shards) {
+            std::remove((shard.output + ".log").c_str());
+            std::remove((shard.output + ".avi").c_str());
+            std::remove((shard.output + ".out").c_str());
+        }
+        return true;
+    }
+
+    bool ShardCoordinator::start_shard(shard_t &shard) {
+        std::vector<std::string> arguments = {
+                m_program, m_video_folder, std::to_string(m_camera_index),
+                "-s", std::to_string(shard.start_frame),
+                "-e", std::to_string(shard.end_frame),
+                "-j", std::to_string(m_step_size),
+                "-t", "1",
+                "--warmup", std::to_string(tmd::Config::bgs_warmup_frames),
+                "--shard-output", shard.output,
+                // Their models only saw the warm-up, not the whole video.
+                "--no-checkpoints"
+        };
+        std::vector<char *> argv;
+        for (std::string &argument : arguments) {
+            argv.push_back(&argument[0]);
+        }
+        argv.push_back(NULL);
+
+        const std::string out_path = shard.output + ".out";
+        shard.pid = fork();
+        if (shard.pid < 0) {
+            std::cout << "Error, couldn't start the shard " << shard.output <<
+            std::endl;
+            return false;
+        }
+        if (shard.pid == 0) {
+            int out = open(out_path.c_str(), O_WRONLY | O_CREAT | O_TRUNC,
+                           0644);
+            if (out >= 0) {
+                dup2(out, STDOUT_FILENO);
+                close(out);
+            }
+            if (!m_executable.empty()) {
+                execv(m_executable.c_str(), argv.data());
+            }
+            else {
+                execvp(m_program.c_str(), argv.data());
+            }
+            _exit(EXIT_FAILURE); // Only reached if exec failed.
+        }
+        tmd::debug("ShardCoordinator", "start_shard", "Frames " +
+                   std::to_string(shard.start_frame) + " to " +
+                   std::to_string(shard.end_frame) + " given to process " +
+                   std::to_string(shard.pid));
+        return true;
+    }
+
+    bool ShardCoordinator::merge_logs(const std::string &log_path) {
+        std::ofstream log(log_path);
+        if (!log.is_open()) {
+            std::cout << "Error, couldn't open " << log_path << std::endl;
+            return false;
+        }
+        for (shard_t &shard : m_shards) {
+            const std::string shard_path = shard.output + ".log";
+            std::ifstream shard_log(shard_path);
+            if (!shard_log.is_open()) {
+                std::cout << "Error, missing log " << shard_path << std::endl;
+                return false;
+            }
+            log << shard_log.rdbuf();
+            shard_log.close();
+        }
+        return true;
+    }
+
+    bool ShardCoordinator::merge_videos(const std::string &video_path) {
+        cv::VideoWriter *writer = NULL;
+        for (shard_t &shard : m_shards) {
+            const std::string shard_path = shard.output + ".avi";
+            cv::VideoCapture shard_video(shard_path);
+            if (!shard_video.isOpened()) {
+                std::cout << "Error, missing video " << shard_path <<
+                std::endl;
+                delete writer;
+                return false;
+            }
+            cv::Mat frame;
+            while (shard_video.read(frame)) {
+                if (writer == NULL) {
+                    // Same settings as the results of the shards.
+                    writer = new cv::VideoWriter(
+                            video_path, CV_FOURCC('M', 'P', '4', 'V'),
+                            shard_video.get(CV_CAP_PROP_FPS), frame.size(),
+                            true);
+                }
+                writer->write(frame);
+            }
+            shard_video.release();
+        }
+        delete writer;
+        return true;
+    }
+}
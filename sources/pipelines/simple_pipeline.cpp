@@ -7,78 +7,101 @@ namespace tmd {
                 : Pipeline(video_folder, camera_index, start_frame, end_frame,
                 step_size) {
 
+        m_input = NULL;
+        m_updates = NULL;
+        m_next_update = NULL;
         m_bgSubstractor = new BGSubstractor(video_folder, camera_index,
                                             start_frame, end_frame, step_size);
+        m_detectionStage = new DetectionStage();
+        m_compute_ticks = 0;
+    }
 
-        if (tmd::Config::use_dpm_player_extractor){
-            m_playerExtractor = new DPMPlayerExtractor();
-        }
-        else {
-            m_playerExtractor = new BlobPlayerExtractor();
-        }
+    SimplePipeline::SimplePipeline(std::string video_folder, int camera_index,
+                int start_frame, int end_frame, int step_size,
+                tmd::FrameDecoder *decoder, int decoder_output,
+                int update_output)
+                : Pipeline(video_folder, camera_index, start_frame, end_frame,
+                step_size) {
 
-        m_featuresComparator = new FeatureComparator
-                (tmd::Config::features_comparator_center_count,
-                 tmd::Config::features_comparator_sample_cols,
-                             FeatureComparator::readCentersFromFile());
-        m_featuresExtractor = new FeaturesExtractor();
+        m_input = decoder->get_output(decoder_output);
+        m_updates = update_output < 0 ? NULL :
+                    decoder->get_update_output(update_output);
+        m_next_update = NULL;
+        m_bgSubstractor = new BGSubstractor(decoder->get_first_frame(),
+                                            camera_index);
+        // The decoder doesn't give us the frames before the starting one.
+        m_bgSubstractor->catch_up(video_folder, start_frame);
+        m_detectionStage = new DetectionStage();
+        m_compute_ticks = 0;
     }
 
     SimplePipeline::~SimplePipeline() {
+        if (m_next_update != NULL) {
+            free_frame(m_next_update);
+        }
         delete m_bgSubstractor;
-        delete m_playerExtractor;
-        delete m_featuresExtractor;
-        delete m_featuresComparator;
+        delete m_detectionStage;
     }
 
     frame_t *SimplePipeline::next_frame() {
-        frame_t *frame = m_bgSubstractor->next_frame();
+        frame_t *frame = NULL;
+        long long start_ticks = cv::getTickCount();
+        if (m_input == NULL) {
+            frame = m_bgSubstractor->next_frame();
+        }
+        else {
+            // The frames only updating the model are not returned.
+            while (m_input->pop(frame) && frame != NULL) {
+                start_ticks = cv::getTickCount();
+                if (m_updates != NULL && !frame->update_only) {
+                    apply_updates(frame->frame_index);
+                }
+                m_bgSubstractor->process_frame(frame);
+                if (!frame->update_only) {
+                    break;
+                }
+                m_compute_ticks += cv::getTickCount() - start_ticks;
+                free_frame(frame);
+                frame = NULL;
+            }
+        }
         if (frame == NULL) {
             return NULL;
         }
 
-        if (!tmd::Config::use_bgs){
-            const int rows = frame->original_frame.rows;
-            const int cols = frame->original_frame.cols;
-            frame->mask_frame = cv::Mat::ones(rows, cols, CV_8U);
-            frame->colored_mask_frame = frame->original_frame;
-            cv::Rect blob = cv::Rect(0, 0, rows, cols);
-            frame->blobs.clear();
-            frame->blobs.push_back(blob);
-        }
-
         tmd::debug("SimplePipeline", "next_frame", "Extracting players.");
-        extract_players_from_frame(frame);
+        m_detectionStage->process_frame(frame);
+        m_compute_ticks += cv::getTickCount() - start_ticks;
 
         return frame;
     }
 
+    void SimplePipeline::apply_updates(int frame_index) {
+        // The decoder pushes the update frames before the frames following
+        // them, so the ones before frame_index are all there : no need to
+        // wait.
+        while (m_next_update != NULL || m_updates->try_pop(m_next_update)) {
+            if (m_next_update->frame_index > frame_index) {
+                return;
+            }
+            if (m_next_update->frame_index < frame_index) {
+                m_bgSubstractor->process_frame(m_next_update);
+            }
+            free_frame(m_next_update);
+            m_next_update = NULL;
+        }
+    }
+
+    long long SimplePipeline::take_compute_ticks() {
+        const long long ticks = m_compute_ticks;
+        m_compute_ticks = 0;
+        return ticks;
+    }
+
     void SimplePipeline::set_bgs_properties(float threshold, int history_size,
                                             float learning_rate) {
         m_bgSubstractor->set_threshold_value(threshold);
         m_bgSubstractor->set_history_size(history_size);
         m_bgSubstractor->set_learning_rate(learning_rate);
     }
-
-    void SimplePipeline::extract_players_from_frame(tmd::frame_t *frame) {
-        tmd::debug("SimplePipeline", "next_frame", "Extracting players.");
-        std::vector<tmd::player_t *> players =
-                m_playerExtractor->extract_player_from_frame(frame);
-
-        tmd::debug("SimplePipeline", "next_frame",std::to_string(players.size())
-                                              + " players/blobs extracted.");
-
-        if (!tmd::Config::use_dpm_player_extractor && tmd::Config::use_bgs){
-            tmd::debug("SimplePipeline", "next_frame", "Separate blobs.");
-            players = BlobSeparator::separate_blobs(players);
-            tmd::debug("SimplePipeline", "next_frame", "Done");
-        }
-
-        tmd::debug("SimplePipeline", "next_frame", "Frame " + std::to_string
-                (m_bgSubstractor->get_current_frame_index()) + " : " +
-                       std::to_string(players.size()) + " players detected");
-        m_featuresExtractor->extractFeaturesFromPlayers(players);
-        m_featuresComparator->detectTeamForPlayers(players);
-        frame->players = players;
-    }
 }
\ No newline at end of file
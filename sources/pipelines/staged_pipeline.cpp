@@ -0,0 +1,107 @@
+#include "../../headers/pipelines/staged_pipeline.h"
+
+namespace tmd {
+    StagedPipeline::StagedPipeline(std::string video_folder, int camera_index,
+             int thread_count, int start_frame, int end_frame, int step_size)
+            : Pipeline(video_folder, camera_index, start_frame, end_frame,
+                       step_size) {
+        if (thread_count <= 0) {
+            throw std::invalid_argument("Error : In staged pipeline : "
+                                                "negative thread count");
+        }
+
+        m_bgSubstractor = new BGSubstractor(video_folder, camera_index,
+                                            start_frame, end_frame, step_size);
+        for (int i = 0; i < thread_count; i++) {
+            m_detection_stages.push_back(new DetectionStage());
+        }
+
+        const int buffer_size = tmd::Config::pipeline_buffer_size;
+        m_masked_frames = new BoundedQueue<std::pair<long, frame_t *>>(
+                buffer_size * thread_count);
+        m_results = new ReorderBuffer<frame_t *>(buffer_size * thread_count);
+
+        m_stop_request = false;
+        m_done = false;
+        m_bgs_worker = std::thread(&StagedPipeline::run_bgs_stage,
+                                   std::ref(*this));
+        for (int i = 0; i < thread_count; i++) {
+            m_detection_workers.push_back(std::thread(
+                    &StagedPipeline::run_detection_stage, std::ref(*this), i));
+        }
+    }
+
+    StagedPipeline::~StagedPipeline() {
+        m_stop_request = true;
+        m_masked_frames->close();
+        std::vector<frame_t *> remaining;
+        m_results->close(remaining);
+
+        m_bgs_worker.join();
+        for (std::thread &worker : m_detection_workers) {
+            worker.join();
+        }
+
+        std::pair<long, frame_t *> entry;
+        while (m_masked_frames->pop(entry)) {
+            free_frame(entry.second);
+        }
+        for (frame_t *frame : remaining) {
+            free_frame(frame);
+        }
+
+        delete m_masked_frames;
+        delete m_results;
+        for (DetectionStage *stage : m_detection_stages) {
+            delete stage;
+        }
+        delete m_bgSubstractor;
+    }
+
+    frame_t *StagedPipeline::next_frame() {
+        if (m_done) {
+            return NULL;
+        }
+        frame_t *frame = NULL;
+        if (!m_results->pop(frame) || frame == NULL) {
+            m_done = true;
+            return NULL;
+        }
+        return frame;
+    }
+
+    void StagedPipeline::run_bgs_stage() {
+        long sequence = 0;
+        while (!m_stop_request) {
+            frame_t *frame = m_bgSubstractor->next_frame();
+            if (frame == NULL) {
+                break;
+            }
+            tmd::debug("StagedPipeline", "run_bgs_stage", "Frame " +
+                       std::to_string(frame->frame_index) + " masked");
+            if (!m_masked_frames->push(std::make_pair(sequence, frame))) {
+                free_frame(frame);
+                break;
+            }
+            sequence++;
+        }
+        // The detection threads stop once they have emptied the queue, and
+        // the NULL entry tells the consumer there is no frame left.
+        m_masked_frames->close();
+        m_results->push(sequence, NULL);
+    }
+
+    void StagedPipeline::run_detection_stage(int thread_id) {
+        DetectionStage *stage = m_detection_stages[thread_id];
+        std::pair<long, frame_t *> entry;
+        while (!m_stop_request && m_masked_frames->pop(entry)) {
+            tmd::debug("StagedPipeline", "run_detection_stage", "Thread " +
+                       std::to_string(thread_id) + " processing frame " +
+                       std::to_string(entry.second->frame_index));
+            stage->process_frame(entry.second);
+            if (!m_results->push(entry.first, entry.second)) {
+                free_frame(entry.second);
+            }
+        }
+    }
+}
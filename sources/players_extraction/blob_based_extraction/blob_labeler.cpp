@@ -0,0 +1,259 @@
+#include "../../../headers/players_extraction/blob_based_extraction/blob_labeler.h"
+#include "../../../headers/misc/thread_pool.h"
+#include <algorithm>
+
+namespace {
+    // Below this height, a strip costs more to schedule than to label.
+    const int MIN_STRIP_ROWS = 32;
+
+    /**
+     * Run the tasks on the thread pool, or directly if there is only one.
+     */
+    void run_tasks(const std::vector<tmd::ThreadPool::task_t> &tasks) {
+        if (tasks.size() == 1) {
+            tasks[0]();
+        }
+        else {
+            tmd::ThreadPool::get_instance()->run_all(tasks);
+        }
+    }
+}
+
+namespace tmd {
+    std::vector<tmd::blob_t> BlobLabeler::label(const tmd::PackedMask &mask,
+                                                const cv::Rect &roi,
+                                                int radius) {
+        const cv::Rect box = roi & cv::Rect(0, 0, mask.get_cols(),
+                                            mask.get_rows());
+
+        tmd::ThreadPool *pool = tmd::ThreadPool::get_instance();
+        const int strip_count = std::max(1, std::min(
+                pool->get_thread_count(), box.height / MIN_STRIP_ROWS));
+        std::vector<int> strip_begin(strip_count + 1);
+        for (int strip = 0; strip <= strip_count; strip++) {
+            strip_begin[strip] = box.height * strip / strip_count;
+        }
+
+        // Every strip finds its runs...
+        m_strip_runs.resize(strip_count);
+        m_strip_row_start.resize(strip_count);
+        std::vector<tmd::ThreadPool::task_t> tasks;
+        for (int strip = 0; strip < strip_count; strip++) {
+            const cv::Rect strip_box(box.x, box.y + strip_begin[strip],
+                                     box.width, strip_begin[strip + 1] -
+                                                strip_begin[strip]);
+            tasks.push_back([this, &mask, strip_box, strip]{
+                find_runs(mask, strip_box, m_strip_runs[strip],
+                          m_strip_row_start[strip]);
+            });
+        }
+        run_tasks(tasks);
+
+        // ... which are put one after the other.
+        m_runs.clear();
+        m_row_start.assign(1, 0);
+        for (int strip = 0; strip < strip_count; strip++) {
+            const int offset = static_cast<int>(m_runs.size());
+            m_runs.insert(m_runs.end(), m_strip_runs[strip].begin(),
+                          m_strip_runs[strip].end());
+            for (size_t row = 1; row < m_strip_row_start[strip].size();
+                 row++) {
+                m_row_start.push_back(offset + m_strip_row_start[strip][row]);
+            }
+        }
+        const int run_count = static_cast<int>(m_runs.size());
+        m_parent.resize(run_count);
+        for (int run = 0; run < run_count; run++) {
+            m_parent[run] = run;
+        }
+
+        // Every strip connects the runs of its rows, which only changes the
+        // parents of its own runs...
+        tasks.clear();
+        for (int strip = 0; strip < strip_count; strip++) {
+            const int begin = strip_begin[strip];
+            const int end = strip_begin[strip + 1];
+            tasks.push_back([this, begin, end, radius]{
+                for (int row = begin; row < end; row++) {
+                    connect_row(row, radius);
+                    connect_rows(row, std::max(begin, row - radius), row,
+                                 radius);
+                }
+            });
+        }
+        run_tasks(tasks);
+
+        // ... then the first rows of every strip are connected to the
+        // strips above.
+        for (int strip = 1; strip < strip_count; strip++) {
+            const int begin = strip_begin[strip];
+            const int end = std::min(strip_begin[strip + 1], begin + radius);
+            for (int row = begin; row < end; row++) {
+                connect_rows(row, std::max(0, row - radius), begin, radius);
+            }
+        }
+
+        return finish();
+    }
+
+    void BlobLabeler::start(const cv::Rect &roi, int radius) {
+        m_roi = roi;
+        m_radius = radius;
+        m_runs.clear();
+        m_row_start.assign(1, 0);
+        m_parent.clear();
+    }
+
+    void BlobLabeler::add_row(const uint64_t *words) {
+        const int row = static_cast<int>(m_row_start.size()) - 1;
+        find_row_runs(words, m_roi.y + row, m_roi.x, m_roi.x + m_roi.width,
+                      m_runs);
+        m_row_start.push_back(static_cast<int>(m_runs.size()));
+        for (int run = static_cast<int>(m_parent.size());
+             run < static_cast<int>(m_runs.size()); run++) {
+            m_parent.push_back(run);
+        }
+        connect_row(row, m_radius);
+        connect_rows(row, std::max(0, row - m_radius), row, m_radius);
+    }
+
+    std::vector<tmd::blob_t> BlobLabeler::finish() {
+        const int run_count = static_cast<int>(m_runs.size());
+
+        // A parent always comes before its child, so a single pass makes
+        // every run point to the root of its blob.
+        for (int run = 0; run < run_count; run++) {
+            m_parent[run] = m_parent[m_parent[run]];
+        }
+
+        // The root of a blob is its first run, so the blobs are created in
+        // the order of their first pixel.
+        std::vector<int> blob_of_root(run_count, -1);
+        std::vector<tmd::blob_t> blobs;
+        std::vector<cv::Point> bottom_right; // Last row and column.
+        for (int run = 0; run < run_count; run++) {
+            const tmd::run_t &current = m_runs[run];
+            const int root = m_parent[run];
+            if (blob_of_root[root] < 0) {
+                blob_of_root[root] = static_cast<int>(blobs.size());
+                tmd::blob_t blob;
+                blob.box = cv::Rect(current.begin, current.row, 0, 0);
+                blob.area = 0;
+                blobs.push_back(blob);
+                bottom_right.push_back(cv::Point(current.end - 1,
+                                                 current.row));
+            }
+            const int index = blob_of_root[root];
+            tmd::blob_t &blob = blobs[index];
+            blob.area += current.end - current.begin;
+            blob.box.x = std::min(blob.box.x, current.begin);
+            bottom_right[index].x = std::max(bottom_right[index].x,
+                                             current.end - 1);
+            bottom_right[index].y = current.row;
+        }
+        for (size_t i = 0; i < blobs.size(); i++) {
+            blobs[i].box.width = bottom_right[i].x - blobs[i].box.x + 1;
+            blobs[i].box.height = bottom_right[i].y - blobs[i].box.y + 1;
+        }
+        return blobs;
+    }
+
+    void BlobLabeler::find_runs(const tmd::PackedMask &mask,
+                                const cv::Rect &roi,
+                                std::vector<tmd::run_t> &runs,
+                                std::vector<int> &row_start) {
+        runs.clear();
+        row_start.assign(1, 0);
+        for (int row = roi.y; row < roi.y + roi.height; row++) {
+            find_row_runs(mask.get_row(row), row, roi.x, roi.x + roi.width,
+                          runs);
+            row_start.push_back(static_cast<int>(runs.size()));
+        }
+    }
+
+    void BlobLabeler::find_row_runs(const uint64_t *words, int row,
+                                    int begin, int end,
+                                    std::vector<tmd::run_t> &runs) {
+        int col = begin;
+        while (col < end) {
+            // Next foreground pixel.
+            int word = col >> 6;
+            uint64_t bits = words[word] & (~uint64_t(0) << (col & 63));
+            while (bits == 0 && (word + 1) * 64 < end) {
+                bits = words[++word];
+            }
+            if (bits == 0) {
+                break;
+            }
+            const int run_begin = word * 64 + __builtin_ctzll(bits);
+            if (run_begin >= end) {
+                break;
+            }
+
+            // Next background pixel.
+            bits = ~words[word] & (~uint64_t(0) << (run_begin & 63));
+            while (bits == 0 && (word + 1) * 64 < end) {
+                bits = ~words[++word];
+            }
+            col = bits == 0 ? end : std::min(
+                    end, word * 64 + __builtin_ctzll(bits));
+
+            tmd::run_t run;
+            run.row = row;
+            run.begin = run_begin;
+            run.end = col;
+            runs.push_back(run);
+        }
+    }
+
+    void BlobLabeler::connect_row(int row, int radius) {
+        // A run is connected to the previous one if they are close enough.
+        for (int run = m_row_start[row] + 1; run < m_row_start[row + 1];
+             run++) {
+            if (m_runs[run].begin < m_runs[run - 1].end + radius) {
+                unite(run, run - 1);
+            }
+        }
+    }
+
+    void BlobLabeler::connect_rows(int row, int begin, int end, int radius) {
+        const int first = m_row_start[row];
+        const int last = m_row_start[row + 1];
+        for (int other = begin; other < end; other++) {
+            int candidate = m_row_start[other];
+            const int candidate_end = m_row_start[other + 1];
+            for (int run = first; run < last; run++) {
+                const tmd::run_t &current = m_runs[run];
+                while (candidate < candidate_end &&
+                       m_runs[candidate].end + radius <= current.begin) {
+                    candidate++;
+                }
+                for (int i = candidate; i < candidate_end &&
+                                        m_runs[i].begin <
+                                        current.end + radius; i++) {
+                    unite(run, i);
+                }
+            }
+        }
+    }
+
+    int BlobLabeler::find(int run) {
+        while (m_parent[run] != run) {
+            m_parent[run] = m_parent[m_parent[run]];
+            run = m_parent[run];
+        }
+        return run;
+    }
+
+    void BlobLabeler::unite(int a, int b) {
+        a = find(a);
+        b = find(b);
+        // The first run stays the root.
+        if (a < b) {
+            m_parent[b] = a;
+        }
+        else if (b < a) {
+            m_parent[a] = b;
+        }
+    }
+}
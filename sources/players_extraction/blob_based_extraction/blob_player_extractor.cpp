@@ -1,142 +1,89 @@
 #include "../../../headers/players_extraction/blob_based_extraction/blob_player_extractor.h"
 #include "../../../headers/data_structures/frame_t.h"
+#include <cmath>
+#include <atomic>
 
 using namespace cv;
 
+namespace {
+    // Negative until set_min_blob_size() is called.
+    std::atomic<int> min_blob_size(-1);
+}
+
 namespace tmd {
     std::vector<player_t *> BlobPlayerExtractor::extract_player_from_frame(
             tmd::frame_t *frame) {
 
-        Mat maskImage;
-        frame->mask_frame.copyTo(maskImage);
-        int rows = maskImage.rows;
-        int cols = maskImage.cols;
-
-        int currentLabel = 1;
-
-        Mat labels;
-        labels = Mat::zeros(rows, cols, CV_32SC1);
-        int smallestLabel;
-        int label;
-        int maxLabel = std::numeric_limits<int>::max();
+        // The blobs are found in the packed mask of the BGS, which may be
+        // reduced : their rectangles are then scaled back to the size of
+        // the frame.
+        PackedMask packed;
+        const PackedMask *maskImage = &frame->packed_mask;
+        if (maskImage->empty()) {
+            packed = PackedMask(frame->mask_frame);
+            maskImage = &packed;
+        }
+        int rows = maskImage->get_rows();
+        int cols = maskImage->get_cols();
+        const int frameRows = frame->original_frame.rows;
+        const int frameCols = frame->original_frame.cols;
+        const double scaleX = static_cast<double>(frameCols) / cols;
+        const double scaleY = static_cast<double>(frameRows) / rows;
+
+        // Outside of this rectangle, there is no foreground.
+        Rect roi(0, 0, cols, rows);
+        if (frame->mask_roi.area() > 0) {
+            int left = static_cast<int>(frame->mask_roi.x / scaleX);
+            int top = static_cast<int>(frame->mask_roi.y / scaleY);
+            int right = static_cast<int>(std::ceil(
+                    (frame->mask_roi.x + frame->mask_roi.width) / scaleX));
+            int bottom = static_cast<int>(std::ceil(
+                    (frame->mask_roi.y + frame->mask_roi.height) / scaleY));
+            roi = Rect(left, top, right - left, bottom - top) &
+                  Rect(0, 0, cols, rows);
+        }
 
-        std::map<int, std::set<int>> labelMap;
+        // Two pixels are in the same blob if they are connected through
+        // pixels at most BUFFER_SIZE / 2 rows and columns away from each
+        // other.
+        // The BGS may have labeled them already, while cleaning the mask.
         const int BUFFER_SIZE = Config::blob_player_extractor_buffer_size;
-        for (int row = 0; row < rows; row++) {
-            for (int col = 0; col < cols; col++) {
-                if (maskImage.at<uchar>(row, col) != 0) {
-                    std::set<int> neighbours;
-                    smallestLabel = maxLabel;
-
-                    for (int bufferCol = -BUFFER_SIZE / 2;
-                         bufferCol <= BUFFER_SIZE / 2;
-                         bufferCol++) {
-
-                        for (int bufferRow = -BUFFER_SIZE / 2;
-                             bufferRow <= BUFFER_SIZE / 2;
-                             bufferRow++) {
-
-                            if (!clamp(rows, cols, row + bufferRow,
-                                       col + bufferCol)) {
-
-                                if (labels.at<int>(row + bufferRow,
-                                                   col + bufferCol) != 0) {
-
-                                    label = labels.at<int>(row + bufferRow,
-                                                           col + bufferCol);
-
-                                    neighbours.insert(label);
-
-                                    smallestLabel = label < smallestLabel ?
-                                                    label : smallestLabel;
-                                }
-                            }
-                        }
-                    }
-
-                    if (neighbours.empty()) {
-                        std::set<int> setTmp;
-                        setTmp.insert(currentLabel);
-
-                        labelMap.insert(std::pair<int,std::set<int>>
-                                                (currentLabel, setTmp));
-
-                        labels.at<int>(row, col) = currentLabel;
-                        currentLabel++;
-                    } else {
-                        labels.at<int>(row, col) = smallestLabel;
-                        for (int tmp : neighbours) {
-                            for (int tmp2 : neighbours) {
-                                labelMap[tmp].insert(tmp2);
-                            }
-                            labelMap[tmp].insert(smallestLabel);
-                        }
-                        labelMap[smallestLabel].insert(smallestLabel);
-                    }
-                }
-            }
+        std::vector<blob_t> blobs;
+        if (frame->mask_blobs_radius == BUFFER_SIZE / 2) {
+            blobs = frame->mask_blobs;
         }
-
-        std::map<int, int> blobSizes;
-
-        for (int row = 0; row < rows; row++) {
-            for (int col = 0; col < cols; col++) {
-                if (maskImage.at<uchar>(row, col) != 0) {
-                    std::set<int> set = labelMap[labels.at<int>(row, col)];
-                    std::set<int>::iterator iter = set.begin();
-                    label = *iter;
-
-                    labels.at<int>(row, col) = label;
-                    int currentSize = 0;
-                    std::map<int, int>::iterator it = blobSizes.find(label);
-
-                    if (it != blobSizes.end()) {
-                        currentSize = it.operator*().second;
-                    }
-
-                    currentSize++;
-                    blobSizes[label] = currentSize;
-                }
-            }
+        else {
+            blobs = m_labeler.label(*maskImage, roi, BUFFER_SIZE / 2);
         }
 
+        const int minBlobSize = get_min_blob_size();
         std::vector<player_t *> players;
-        for (auto iterator = blobSizes.begin(); iterator != blobSizes.end();
-             iterator++) {
+        for (const blob_t &blob : blobs) {
 
-            if(iterator->second >= Config::blob_player_extractor_min_blob_size){
+            // The minimum size is in pixels of the frame.
+            if(blob.area * scaleX * scaleY >= minBlobSize){
                 player_t *player = new player_t;
-                label = iterator->first;
-                int minRow = std::numeric_limits<int>::max();
-                int minCol = std::numeric_limits<int>::max();
-                int maxRow = std::numeric_limits<int>::min();
-                int maxCol = std::numeric_limits<int>::min();
-                for (int row = 0; row < rows; row++) {
-                    for (int col = 0; col < cols; col++) {
-                        if (labels.at<int>(row, col) == label) {
-                            if (row < minRow) {
-                                minRow = row;
-                            }
-                            if (col < minCol) {
-                                minCol = col;
-                            }
-                            if (row > maxRow) {
-                                maxRow = row;
-                            }
-                            if (col > maxCol) {
-                                maxCol = col;
-                            }
-                        }
-                    }
+                int minRow = blob.box.y;
+                int minCol = blob.box.x;
+                int maxRow = blob.box.y + blob.box.height - 1;
+                int maxCol = blob.box.x + blob.box.width - 1;
+
+                if (rows != frameRows || cols != frameCols) {
+                    minCol = static_cast<int>(minCol * scaleX);
+                    minRow = static_cast<int>(minRow * scaleY);
+                    maxCol = static_cast<int>(
+                            std::ceil((maxCol + 1) * scaleX)) - 1;
+                    maxRow = static_cast<int>(
+                            std::ceil((maxRow + 1) * scaleY)) - 1;
                 }
 
                 int tpX = (minCol - 20) < 0 ? 0 : (minCol - 20);
                 int tpY = (minRow - 20) < 0 ? 0 : (minRow - 20);
-                int btX = (maxCol + 20) > cols ? cols : (maxCol + 20);
-                int btY = (maxRow + 20) > rows ? rows : (maxRow + 20);
+                int btX = (maxCol + 20) > frameCols ? frameCols : (maxCol + 20);
+                int btY = (maxRow + 20) > frameRows ? frameRows : (maxRow + 20);
                 cv::Rect myRect(tpX, tpY, btX - tpX, btY - tpY);
                 frame->blobs.push_back(myRect);
-                player->mask_image = frame->mask_frame(myRect);
+                player->mask_image = get_mask(frame)(myRect);
                 player->pos_frame = myRect;
                 player->team = TEAM_UNKNOWN;
                 player->original_image = frame->original_frame(myRect);
@@ -148,8 +95,12 @@ namespace tmd {
         return players;
     }
 
-    bool BlobPlayerExtractor::clamp(int rows, int cols, int row, int col) {
-        return row < 0 || row >= rows || col < 0 || col >= cols;
+    void BlobPlayerExtractor::set_min_blob_size(int size) {
+        min_blob_size = size;
     }
 
+    int BlobPlayerExtractor::get_min_blob_size() {
+        const int size = min_blob_size;
+        return size < 0 ? Config::blob_player_extractor_min_blob_size : size;
+    }
 }
\ No newline at end of file
@@ -1,6 +1,8 @@
+#include <algorithm>
 #include "../../../headers/players_extraction/blob_based_extraction/blob_separator.h"
 #include "../../../headers/features_extraction/dpm.h"
 #include "../../../headers/data_structures/frame_t.h"
+#include "../../../headers/misc/thread_pool.h"
 
 namespace tmd {
     std::vector<tmd::player_t *> BlobSeparator::separate_blobs(
@@ -9,47 +11,82 @@ namespace tmd {
 
         size_t size = players.size();
 
-        // freed
-        DPM *dpm = new DPM();
+        // One result slot per blob, so that the output order does not depend
+        // on the order in which the tasks finish.
+        std::vector<std::vector<player_t *>> players_in_blobs(size);
 
+        // The biggest blobs are the slowest to handle, start them first.
+        std::vector<size_t> order;
         for (size_t i = 0; i < size; i++) {
             player_t *p = players[i];
-            if (p->original_image.rows < 100 || p->original_image.cols < 50) {
-                free_player(p);
-                continue;
+            if (p->original_image.rows >= 100 && p->original_image.cols >= 50) {
+                order.push_back(i);
             }
-            frame_t *blob_frame = new frame_t; // freed
-            blob_frame->original_frame = p->original_image;
-            blob_frame->mask_frame = p->mask_image;
-            blob_frame->frame_index = p->frame_index;
-            cv::Mat colored_mask =
-                    tmd::get_colored_mask_for_frame(blob_frame);
-            blob_frame->colored_mask_frame = colored_mask;
-
-
-            tmd::debug("BlobSeparator", "separate_blobs", "Extract players "
-                    "from blob.");
-            std::vector<player_t *> players_in_blob =
-                    dpm->extract_players_and_body_parts(blob_frame);
-            // freed
-            tmd::debug("BlobSeparator", "separate_blobs", "Done : " +
-                          std::to_string(players_in_blob.size()) + " players "
-                                  "extracted.");
-            // Here the blob has multiple players in it.
-            for (size_t j = 0; j < players_in_blob.size(); j++) {
-                tmd::debug("BlobSeparator", "separate_blobs", "Player " +
-                              std::to_string(j) + " has score " +
-                              std::to_string(players_in_blob[j]->likelihood));
-
-                player_t *pi = players_in_blob[j];
-                pi->pos_frame.x += p->pos_frame.x;
-                pi->pos_frame.y += p->pos_frame.y;
+        }
+        std::stable_sort(order.begin(), order.end(),
+                         [&players](size_t a, size_t b) {
+                             return players[a]->pos_frame.area() >
+                                    players[b]->pos_frame.area();
+                         });
+
+        std::vector<tmd::ThreadPool::task_t> tasks;
+        for (size_t i : order) {
+            player_t *p = players[i];
+            std::vector<player_t *> *result = &players_in_blobs[i];
+            tasks.push_back([p, result] {
+                *result = separate_blob(p);
+            });
+        }
+        tmd::ThreadPool::get_instance()->run_all(tasks);
+
+        for (size_t i = 0; i < size; i++) {
+            for (player_t *pi : players_in_blobs[i]) {
                 new_player_vector.push_back(pi);
             }
-            free_player(p);
-            free_frame(blob_frame);
+            free_player(players[i]);
         }
-        delete dpm;
         return new_player_vector;
     }
-}
\ No newline at end of file
+
+    std::vector<tmd::player_t *> BlobSeparator::separate_blob(
+            tmd::player_t *p) {
+        // The DPM keeps the detections of its current call, so every blob
+        // has its own. They all share the same model.
+        DPM dpm;
+
+        frame_t *blob_frame = new frame_t; // freed
+        if (tmd::Config::use_colored_mask_in_dpm) {
+            blob_frame->original_frame = p->original_image;
+        }
+        else {
+            // The DPM converts its input in place and neighbouring blobs can
+            // overlap in the original frame.
+            blob_frame->original_frame = p->original_image.clone();
+        }
+        blob_frame->mask_frame = p->mask_image;
+        blob_frame->frame_index = p->frame_index;
+        // The colored mask is computed by the DPM, if it needs it.
+
+
+        tmd::debug("BlobSeparator", "separate_blob", "Extract players "
+                "from blob.");
+        std::vector<player_t *> players_in_blob =
+                dpm.extract_players_and_body_parts(blob_frame);
+        // freed
+        tmd::debug("BlobSeparator", "separate_blob", "Done : " +
+                      std::to_string(players_in_blob.size()) + " players "
+                              "extracted.");
+        // Here the blob has multiple players in it.
+        for (size_t j = 0; j < players_in_blob.size(); j++) {
+            tmd::debug("BlobSeparator", "separate_blob", "Player " +
+                          std::to_string(j) + " has score " +
+                          std::to_string(players_in_blob[j]->likelihood));
+
+            player_t *pi = players_in_blob[j];
+            pi->pos_frame.x += p->pos_frame.x;
+            pi->pos_frame.y += p->pos_frame.y;
+        }
+        free_frame(blob_frame);
+        return players_in_blob;
+    }
+}
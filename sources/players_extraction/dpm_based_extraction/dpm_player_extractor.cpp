@@ -17,12 +17,10 @@ namespace tmd {
 
     void DPMPlayerExtractor::set_overlapping_threshold(float th){
         tmd::Config::dpm_extractor_overlapping_threshold = th;
-        recreate_detector();
     }
 
     void DPMPlayerExtractor::set_score_threshold(float th){
         tmd::Config::dpm_extractor_score_threshold = th;
-        recreate_detector();
     }
 
     float DPMPlayerExtractor::get_overlapping_threshold(){
@@ -32,9 +30,4 @@ namespace tmd {
     float DPMPlayerExtractor::get_score_threshold(){
         return tmd::Config::dpm_extractor_score_threshold;
     }
-
-    void DPMPlayerExtractor::recreate_detector(){
-        delete m_detector;
-        m_detector = new tmd::DPM();
-    }
 }
\ No newline at end of file
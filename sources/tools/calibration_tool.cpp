@@ -53,6 +53,7 @@ namespace tmd {
                                 m_params[m_current_camera][HISTORY_SIZE_IDX]) +
                         "   Learning rate : " + std::to_string(
                                 m_params[m_current_camera][LEARNING_RATE_IDX]);
+                tmd::get_mask(frame);
                 cv::putText((frame->mask_frame), infos.c_str(),
                             cv::Point(15, 15), cv::FONT_HERSHEY_SIMPLEX, 0.5,
                             cv::Scalar(0, 0, 0));
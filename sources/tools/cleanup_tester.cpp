@@ -0,0 +1,129 @@
+#include "../../headers/tools/cleanup_tester.h"
+
+namespace tmd {
+    bool CleanupTester::test_cleanup(int mask_count, unsigned int seed) {
+        // The masks are cleaned at their own size.
+        tmd::Config::bgs_downscale_factor = 1;
+        tmd::BGSubstractor bgs(cv::Mat::zeros(64, 64, CV_8UC3), 0);
+
+        std::mt19937 generator(seed);
+        int failures = 0;
+        for (int i = 0; i < mask_count; i++) {
+            const int rows = 1 + static_cast<int>(generator() % 120);
+            const int cols = 1 + static_cast<int>(generator() % 150);
+            const int buffer_size = static_cast<int>(generator() % 5);
+            const int window = (2 * buffer_size + 1) * (2 * buffer_size + 1);
+            const int count_threshold = static_cast<int>(
+                    generator() % (window + 1));
+            const int density = static_cast<int>(generator() % 50);
+
+            // Either the whole frame or a few rectangles, which may touch
+            // the first row and column.
+            cv::Mat static_mask(rows, cols, CV_8U, cv::Scalar(255));
+            if (generator() % 3 != 0) {
+                static_mask = cv::Scalar(0);
+                const int rectangles = 1 + static_cast<int>(generator() % 4);
+                for (int r = 0; r < rectangles; r++) {
+                    const int x = static_cast<int>(generator() % cols);
+                    const int y = static_cast<int>(generator() % rows);
+                    const int width = 1 + static_cast<int>(
+                            generator() % (cols - x));
+                    const int height = 1 + static_cast<int>(
+                            generator() % (rows - y));
+                    static_mask(cv::Rect(x, y, width, height)) =
+                            cv::Scalar(255);
+                }
+            }
+
+            // Foreground and shadows, only inside of the static mask as
+            // with the bgs.
+            cv::Mat mask(rows, cols, CV_8U);
+            for (int row = 0; row < rows; row++) {
+                uchar *pixels = mask.ptr<uchar>(row);
+                const uchar *allowed = static_mask.ptr<uchar>(row);
+                for (int col = 0; col < cols; col++) {
+                    pixels[col] = 0;
+                    if (allowed[col] != 0 &&
+                        static_cast<int>(generator() % 100) < density) {
+                        pixels[col] = generator() % 4 == 0 ? 127 : 255;
+                    }
+                }
+            }
+
+            tmd::Config::bgs_blob_buffer_size = buffer_size;
+            tmd::Config::bgs_blob_threshold_count = count_threshold;
+            bgs.m_static_mask = static_mask;
+            bgs.update_region();
+            tmd::frame_t frame;
+            bgs.stream_mask(mask, &frame);
+
+            cv::Mat expected = mask.clone();
+            clean_mask(expected, buffer_size, count_threshold);
+
+            int wrong_pixels = 0;
+            for (int row = 0; row < rows; row++) {
+                for (int col = 0; col < cols; col++) {
+                    if (frame.packed_mask.test(row, col) !=
+                        (expected.at<uchar>(row, col) != 0)) {
+                        wrong_pixels++;
+                    }
+                }
+            }
+            if (wrong_pixels > 0) {
+                std::cout << "Mask " << i << " (" << rows << "x" << cols <<
+                ", buffer " << buffer_size << ", threshold " <<
+                count_threshold << ") : " << wrong_pixels <<
+                " wrong pixels" << std::endl;
+                failures++;
+            }
+        }
+
+        std::cout << mask_count << " masks, " << failures << " failures" <<
+        std::endl;
+        return failures == 0;
+    }
+
+    void CleanupTester::clean_mask(cv::Mat &mask, int buffer_size,
+                                   int count_threshold) {
+        cv::Mat mask_copy = mask.clone();
+        cv::Mat checked_pixels = cv::Mat::zeros(mask.rows, mask.cols, CV_8U);
+        for (int row = 0; row < mask.rows; row++) {
+            for (int col = 0; col < mask.cols; col++) {
+                if (mask.at<uchar>(row, col) == 0) {
+                    continue;
+                }
+                for (int dx = -buffer_size; dx <= buffer_size; dx++) {
+                    for (int dy = -buffer_size; dy <= buffer_size; dy++) {
+                        const int x = col + dx;
+                        const int y = row + dy;
+                        if (x <= 0 || x >= mask.cols || y <= 0 ||
+                            y >= mask.rows ||
+                            checked_pixels.at<uchar>(y, x) != 0) {
+                            continue;
+                        }
+                        mask_copy.at<uchar>(y, x) = count_neighbours_in_fg(
+                                mask, x, y, buffer_size) > count_threshold ?
+                                                    255 : 0;
+                        checked_pixels.at<uchar>(y, x) = 255;
+                    }
+                }
+            }
+        }
+        mask = mask_copy;
+    }
+
+    int CleanupTester::count_neighbours_in_fg(const cv::Mat &mask, int x,
+                                              int y, int buffer_size) {
+        int count = 0;
+        for (int row = -buffer_size; row <= buffer_size; row++) {
+            for (int col = -buffer_size; col <= buffer_size; col++) {
+                if (x + col > 0 && x + col < mask.cols && y + row > 0 &&
+                    y + row < mask.rows &&
+                    mask.at<uchar>(y + row, x + col) != 0) {
+                    count++;
+                }
+            }
+        }
+        return count;
+    }
+}
@@ -2,22 +2,11 @@
 
 namespace tmd {
 
-    void apply_mask_on_frame(frame_t *frame) {
-        cv::Vec3b black;
-        black.val[0] = 0;
-        black.val[1] = 0;
-        black.val[2] = 0;
-        cv::Vec3b white;
-        white.val[0] = 255;
-        white.val[1] = 255;
-        white.val[2] = 255;
-        for (int c = 0; c < frame->mask_frame.cols; c++) {
-            for (int r = 0; r < frame->mask_frame.rows; r++) {
-                if (frame->mask_frame.at<uchar>(r, c) == 0) {
-                    frame->original_frame.at<cv::Vec3b>(r, c) = black;
-                }
-            }
-        }
+    void apply_mask_on_frame(frame_t *frame, const cv::Mat &static_mask) {
+        // Only the pixels which are background in one of the masks are
+        // changed.
+        tmd::apply_masks(frame->original_frame, tmd::get_mask(frame),
+                         static_mask, 1, frame->original_frame);
     }
 
     void DPMCalibrator::calibrate_dpm(std::string video_path,
@@ -45,6 +34,9 @@ namespace tmd {
 
         DPMPlayerExtractor dpmPlayerExtractor;
         BGSubstractor bgSubstractor(video_path, 0);
+        // Empty if there is no such file, the whole frame is then used.
+        cv::Mat static_mask = AssetRegistry::get_instance()->get_image(
+                mask_path, 0);
         FeaturesExtractor featuresExtractor;
 
         int keyboard = 0;
@@ -52,7 +44,7 @@ namespace tmd {
         bgSubstractor.jump_to_frame(start_frame);
 
         frame_t *frame = bgSubstractor.next_frame();
-        apply_mask_on_frame(frame);
+        apply_mask_on_frame(frame, static_mask);
 
         cv::Mat frame_cpy(frame->original_frame);
 
@@ -76,7 +68,7 @@ namespace tmd {
                         delete bgSubstractor.next_frame();
                     }
                     frame = bgSubstractor.next_frame();
-                    apply_mask_on_frame(frame);
+                    apply_mask_on_frame(frame, static_mask);
                     break;
 
                 case 'o': // Increase overlapping threshold.
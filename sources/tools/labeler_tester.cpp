@@ -0,0 +1,137 @@
+#include "../../headers/tools/labeler_tester.h"
+
+namespace tmd {
+    bool LabelerTester::test_labeler(int mask_count, unsigned int seed) {
+        // label() only cuts the masks of at least 32 rows per thread in
+        // strips : with 4 threads, the tall masks are cut in several strips
+        // whatever the machine is. The pool is created on its first use.
+        tmd::Config::thread_pool_size = 4;
+
+        std::mt19937 generator(seed);
+        tmd::BlobLabeler labeler;
+        int failures = 0;
+        for (int i = 0; i < mask_count; i++) {
+            const int rows = 1 + static_cast<int>(generator() % 256);
+            const int cols = 1 + static_cast<int>(generator() % 200);
+            const int radius = static_cast<int>(generator() % 9);
+            const int density = static_cast<int>(generator() % 60);
+
+            cv::Mat mask(rows, cols, CV_8U);
+            for (int row = 0; row < rows; row++) {
+                uchar *pixels = mask.ptr<uchar>(row);
+                for (int col = 0; col < cols; col++) {
+                    pixels[col] = static_cast<int>(generator() % 100) <
+                                  density ? 255 : 0;
+                }
+            }
+
+            // Either the whole mask or a random part of it.
+            cv::Rect roi(0, 0, cols, rows);
+            if (generator() % 3 != 0) {
+                roi.x = static_cast<int>(generator() % cols);
+                roi.y = static_cast<int>(generator() % rows);
+                roi.width = 1 + static_cast<int>(
+                        generator() % (cols - roi.x));
+                roi.height = 1 + static_cast<int>(
+                        generator() % (rows - roi.y));
+            }
+
+            const tmd::PackedMask packed(mask, roi);
+            const std::vector<tmd::blob_t> expected =
+                    flood_fill(mask, roi, radius);
+
+            if (!same_blobs(labeler.label(packed, roi, radius), expected)) {
+                std::cout << "Mask " << i << " (" << rows << "x" << cols <<
+                ", radius " << radius << ") : wrong blobs from label()" <<
+                std::endl;
+                failures++;
+            }
+
+            labeler.start(roi, radius);
+            for (int row = roi.y; row < roi.y + roi.height; row++) {
+                labeler.add_row(packed.get_row(row));
+            }
+            if (!same_blobs(labeler.finish(), expected)) {
+                std::cout << "Mask " << i << " (" << rows << "x" << cols <<
+                ", radius " << radius << ") : wrong blobs from add_row()" <<
+                std::endl;
+                failures++;
+            }
+        }
+
+        std::cout << mask_count << " masks, " << failures << " failures" <<
+        std::endl;
+        return failures == 0;
+    }
+
+    std::vector<tmd::blob_t> LabelerTester::flood_fill(const cv::Mat &mask,
+                                                       const cv::Rect &roi,
+                                                       int radius) {
+        // The pixels of a row next to each other are always connected.
+        const int reach = std::max(radius, 1);
+        std::vector<tmd::blob_t> blobs;
+        cv::Mat visited = cv::Mat::zeros(mask.size(), CV_8U);
+        std::vector<cv::Point> stack;
+        for (int row = roi.y; row < roi.y + roi.height; row++) {
+            for (int col = roi.x; col < roi.x + roi.width; col++) {
+                if (!mask.at<uchar>(row, col) ||
+                    visited.at<uchar>(row, col)) {
+                    continue;
+                }
+                int left = col, right = col, top = row, bottom = row;
+                int area = 0;
+                visited.at<uchar>(row, col) = 1;
+                stack.push_back(cv::Point(col, row));
+                while (!stack.empty()) {
+                    const cv::Point pixel = stack.back();
+                    stack.pop_back();
+                    area++;
+                    left = std::min(left, pixel.x);
+                    right = std::max(right, pixel.x);
+                    top = std::min(top, pixel.y);
+                    bottom = std::max(bottom, pixel.y);
+
+                    for (int dy = -radius; dy <= radius; dy++) {
+                        const int y = pixel.y + dy;
+                        if (y < roi.y || y >= roi.y + roi.height) {
+                            continue;
+                        }
+                        // The next pixels of the row are reached even with
+                        // a radius of 0.
+                        const int dx_max = dy == 0 ? reach : radius;
+                        for (int dx = -dx_max; dx <= dx_max; dx++) {
+                            const int x = pixel.x + dx;
+                            if (x < roi.x || x >= roi.x + roi.width ||
+                                !mask.at<uchar>(y, x) ||
+                                visited.at<uchar>(y, x)) {
+                                continue;
+                            }
+                            visited.at<uchar>(y, x) = 1;
+                            stack.push_back(cv::Point(x, y));
+                        }
+                    }
+                }
+
+                tmd::blob_t blob;
+                blob.box = cv::Rect(left, top, right - left + 1,
+                                    bottom - top + 1);
+                blob.area = area;
+                blobs.push_back(blob);
+            }
+        }
+        return blobs;
+    }
+
+    bool LabelerTester::same_blobs(const std::vector<tmd::blob_t> &a,
+                                   const std::vector<tmd::blob_t> &b) {
+        if (a.size() != b.size()) {
+            return false;
+        }
+        for (size_t i = 0; i < a.size(); i++) {
+            if (a[i].box != b[i].box || a[i].area != b[i].area) {
+                return false;
+            }
+        }
+        return true;
+    }
+}
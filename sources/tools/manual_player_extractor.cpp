@@ -33,7 +33,7 @@ namespace tmd {
             cv::Mat cpy = frame->original_frame.clone();
             players.push_back(new player_t);
             players[i]->original_image = cpy(mBoxes[i]);
-            players[i]->mask_image = (frame->mask_frame.clone())(mBoxes[i]);
+            players[i]->mask_image = (get_mask(frame).clone())(mBoxes[i]);
             cv::imwrite("./res/manual_extraction/playeror.jpg",
                         players[i]->original_image);
             cv::imwrite("./res/manual_extraction/playermk.jpg",
@@ -1,9 +1,12 @@
 #!/bin/bash
 
 # Test the basic functionality of the program.
+# An optional argument gives the downscale factor of the background
+# subtraction (bgs_downscale_factor), e.g. test/test.sh 2.
+factor=${1:-1}
 beg=`date`
 echo Begin test : "$beg"
-./Bachelor_Project --test > test_results.out
+./Bachelor_Project --test $factor > test_results.out
 echo Test finished : `date`
 
 # Compare the results with the expected output.
@@ -13,7 +16,16 @@ then
 	echo Test Succeded !
 else
 	echo Test Failed ! Contact us.
+	# Report the team labels which changed, frame by frame.
+	labels=`diff <(awk '/^Frame/ {frame = $0; next} {print frame " : " $0}' \
+			test/expected.out) \
+		<(awk '/^Frame/ {frame = $0; next} {print frame " : " $0}' \
+			test_results.out) | grep "^[<>]"`
+	removed=`echo "$labels" | grep -c "^<"`
+	added=`echo "$labels" | grep -c "^>"`
+	echo "$removed expected team labels missing, $added unexpected ones :"
+	echo "$labels"
 fi
 
 # Delete the results.
-rm test_results.out
\ No newline at end of file
+rm test_results.out
@@ -0,0 +1,20 @@
+#!/bin/bash
+
+# Check the cleanup of the masks of the background subtraction against the
+# former loops (count_neighbours_in_fg) on random masks and static masks.
+echo Begin cleanup test : `date`
+./Bachelor_Project --test-cleanup > test_cleanup.out
+result=$?
+echo Test finished : `date`
+
+if [ $result -eq 0 ]
+then
+	echo Test Succeded !
+else
+	echo Test Failed ! Contact us.
+	grep "^Mask" test_cleanup.out
+fi
+tail -n 1 test_cleanup.out
+
+# Delete the results.
+rm test_cleanup.out
@@ -0,0 +1,21 @@
+#!/bin/bash
+
+# Check the blob labeling (BlobLabeler) against a flood fill on random masks,
+# both with the strips of several threads and with the rows given one at a
+# time.
+echo Begin labeler test : `date`
+./Bachelor_Project --test-labeler > test_labeler.out
+result=$?
+echo Test finished : `date`
+
+if [ $result -eq 0 ]
+then
+	echo Test Succeded !
+else
+	echo Test Failed ! Contact us.
+	grep "^Mask" test_labeler.out
+fi
+tail -n 1 test_labeler.out
+
+# Delete the results.
+rm test_labeler.out